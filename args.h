@@ -73,22 +73,355 @@ USAGE:
 #define ARGS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
 
-// Parse command-line arguments.
+// Result of `*_ex` argument access functions.
+typedef enum {
+  ARGS_OK = 0,      // Value parsed
+  ARGS_ERR_MISSING, // Argument is not given
+  ARGS_ERR_INVALID, // Argument has no value or value is malformed
+  ARGS_ERR_RANGE,   // Value does not fit into the result type
+  ARGS_ERR_NOMEM,   // Out of context memory, for example the arena is full
+} args_err_t;
+
+// Non-owning slice of an argument. `ptr` is NULL if the argument is missing.
+// It is NOT null-terminated.
+typedef struct {
+  const char *ptr;
+  size_t len;
+} args_string_view_t;
+
+// Max number of memory mapped files per context.
+#ifndef ARGS_MAX_FILES
+#define ARGS_MAX_FILES 8
+#endif // ARGS_MAX_FILES
+
+// Parsed command-line arguments.
+// Fields are private, use `args_ctx_*` functions to access them.
+// Context is only read after `args_ctx_init()`, so it can be used from many threads at once.
+// The only exceptions are list results and the lookup cache, which are filled on first use and published atomically.
+typedef struct {
+  int argc;
+  char **argv;
+  struct {
+    char *data;
+    size_t size;
+    size_t map_size;
+    int arg;
+  } files[ARGS_MAX_FILES];
+  int nfiles;
+  struct args__token *tokens;
+  size_t ntokens;
+  struct args__slot *slots;
+  size_t slots_mask;
+  uint32_t seed;
+  size_t threads;
+  unsigned char *arena;
+  size_t arena_cap;
+  size_t arena_used;
+  struct args__block *heap;
+  struct args__list *lists;
+  struct args__flag *flags;
+  int nflags;
+  struct args__mph *mph;
+  struct args__trie *trie;
+  struct args__abbrevs *abbrevs;
+  struct args__cache *cache;
+  struct args__choices *choices;
+  struct args__layer *layers;
+  uint64_t *consumed;
+  const struct args__value *values;
+} args_ctx_t;
+
+// Parse command-line arguments into `ctx`.
+// Arguments are tokenized once into a hash index, so every access function is a constant time lookup.
+// Argument `@path` is replaced with arguments read from response file `path`, which are separated by whitespace.
+// Whitespace inside double quotes doesn't split an argument, and quotes around a whole argument are removed:
+//   --name "John Smith" --city="New York"
+// The file is memory mapped and its arguments are used in place, without copying.
+// If the file can't be read, `@path` is kept as is. Response files are not expanded recursively.
+// Define `ARGS_NO_RESPONSE_FILES` to disable them.
+void args_ctx_init(args_ctx_t *ctx, int argc, char **argv);
+
+// Same as `args_ctx_init()`, but all memory used by `ctx` is taken from the caller-owned `buf` of `cap` bytes,
+// so parsing never calls `malloc()`. `buf` must outlive `ctx`.
+// Returns number of bytes required. If it is greater than `cap`, the arena is too small and `ctx` is left empty.
+// The size covers parsing and one call each of `args_ctx_unknown()` and `args_ctx_positional()`.
+// Lists, layers, the registry and caches take more, and fail as documented for out of memory once the arena is full.
+// `args_ctx_parse_into()` with more than 32 variants still takes short-lived scratch memory from `ARGS_MALLOC`.
+size_t args_ctx_init_arena(args_ctx_t *ctx, int argc, char **argv, void *buf, size_t cap);
+
+// Limits, hashing and threads of `args_ctx_init_opts()`. Zero fields keep the defaults of `args_ctx_init()`.
+typedef struct {
+  size_t max_tokens;         // Max number of arguments, after response files are expanded
+  size_t max_token_len;      // Max length of an argument in bytes
+  uint32_t seed;             // Seed of the argv index, should be random
+  size_t threads;            // Threads converting long int and float lists, needs `ARGS_THREADS`, see list functions
+  const char *short_options; // Letters of short flag clusters like in `getopt()`, see below
+} args_parse_opts_t;
+
+// Short flag clusters are decoded only if `short_options` is set, like "vqo:I:" in `getopt()`.
+// With it `-vq` is `-v -q`, and a letter followed by ':' takes the rest as its value: `-ofile.txt` is
+// `-o file.txt`, `-vIinclude` is `-v -I include`. `-o` at the end of a cluster takes the next argument.
+// An argument is decoded only if every letter up to the value is listed, so `-version` stays one flag unless
+// all of v, e, r, s, i, o and n are. The cluster itself is always kept, `args_bool("-version")` finds it either way.
+// Arguments with '=' are never decoded. `short_options` must outlive the context and its reloads.
+
+// Same as `args_ctx_init()`, but for command lines that can't be trusted, like generated ones.
+// Parsing is O(argc + total bytes), and is given up as soon as an argument is over a limit of `opts`.
+// Lookups are one probe per variant, but with a fixed hash a command line can be crafted so that all keys
+// collide. With a random `seed`, slots are picked by a keyed hash of the whole key, so a lookup is O(1) expected
+// whatever the input. A key repeated many times costs one walk over its occurrences on the first lookup,
+// which marks them consumed, and a bit test on later ones. List functions read each occurrence once per list.
+// Layers are hashed as usual, they are not meant for untrusted input.
+// Returns `ARGS_ERR_RANGE` if a limit is exceeded, then `ctx` is left empty, otherwise `ARGS_OK`.
+args_err_t args_ctx_init_opts(args_ctx_t *ctx, int argc, char **argv, const args_parse_opts_t *opts);
+
+// Free memory used by `ctx`.
+void args_ctx_free(args_ctx_t *ctx);
+
+// Print command-line arguments of `ctx`.
+void args_ctx_print(const args_ctx_t *ctx);
+
+// Same as `args_format()`, but for `ctx`.
+size_t args_ctx_format(const args_ctx_t *ctx, char *buf, size_t cap);
+
+// Same as functions below, but read arguments from `ctx` instead of the default context.
+bool args_ctx_bool(const args_ctx_t *ctx, const char *arg);
+int args_ctx_int(const args_ctx_t *ctx, const char *arg);
+int64_t args_ctx_int64(const args_ctx_t *ctx, const char *arg);
+uint64_t args_ctx_uint64(const args_ctx_t *ctx, const char *arg);
+size_t args_ctx_size(const args_ctx_t *ctx, const char *arg);
+args_err_t args_ctx_int_ex(const args_ctx_t *ctx, const char *arg, int *out);
+args_err_t args_ctx_int64_ex(const args_ctx_t *ctx, const char *arg, int64_t *out);
+args_err_t args_ctx_uint64_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out);
+args_err_t args_ctx_size_ex(const args_ctx_t *ctx, const char *arg, size_t *out);
+uint64_t args_ctx_bytes(const args_ctx_t *ctx, const char *arg);
+uint64_t args_ctx_duration_ns(const args_ctx_t *ctx, const char *arg);
+args_err_t args_ctx_bytes_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out);
+args_err_t args_ctx_duration_ns_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out);
+double args_ctx_float(const args_ctx_t *ctx, const char *arg);
+args_err_t args_ctx_float_ex(const args_ctx_t *ctx, const char *arg, double *out);
+const char *args_ctx_string(const args_ctx_t *ctx, const char *arg);
+args_string_view_t args_ctx_string_view(const args_ctx_t *ctx, const char *arg);
+int args_ctx_choice(const args_ctx_t *ctx, const char *arg, const char *const *choices, size_t n);
+args_err_t args_ctx_choice_ex(const args_ctx_t *ctx, const char *arg, const char *const *choices, size_t n, int *out);
+const int64_t *args_ctx_int_list(const args_ctx_t *ctx, const char *arg, size_t *count);
+const double *args_ctx_float_list(const args_ctx_t *ctx, const char *arg, size_t *count);
+const args_string_view_t *args_ctx_string_list(const args_ctx_t *ctx, const char *arg, size_t *count);
+
+// Single precomputed variant of an argument, e.g. `--port` of "-p|--port".
+// It lets bindings split specs at compile time instead of on every call, see `args.hpp`.
+typedef struct {
+  const char *name;
+  size_t len;
+  uint32_t hash; // args_hash(name, len)
+} args_key_t;
+
+// Hash function of the index, 32-bit FNV-1a.
+uint32_t args_hash(const char *s, size_t len);
+
+// Same as `args_ctx_*` functions, but take precomputed variants instead of a "|" separated spec.
+bool args_ctx_bool_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys);
+args_err_t args_ctx_int64_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, int64_t *out);
+args_err_t args_ctx_uint64_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, uint64_t *out);
+args_err_t args_ctx_float_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, double *out);
+args_string_view_t args_ctx_string_view_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys);
+// Same as above, but tell a missing argument from a false or empty one.
+// Return `ARGS_ERR_MISSING` if no variant is present, and `ARGS_ERR_INVALID` for a string argument without a value
+// or a boolean `--flag=<value>` whose value is not a boolean word.
+args_err_t args_ctx_bool_keys_ex(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, bool *out);
+args_err_t args_ctx_string_view_keys_ex(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys,
+                                        args_string_view_t *out);
+
+// Type of value in `args_spec_t`.
+typedef enum {
+  ARGS_BOOL,        // bool
+  ARGS_INT,         // int
+  ARGS_INT64,       // int64_t
+  ARGS_UINT64,      // uint64_t
+  ARGS_SIZE,        // size_t
+  ARGS_FLOAT,       // double
+  ARGS_STRING,      // const char *
+  ARGS_STRING_VIEW, // args_string_view_t
+  ARGS_BYTES,       // uint64_t, same as `args_bytes()`
+  ARGS_DURATION,    // uint64_t nanoseconds, same as `args_duration_ns()`
+} args_type_t;
+
+// Declarative description of one option, for `args_parse_into()`.
+typedef struct {
+  const char *name;  // Variants, same as `arg` of access functions: "-p|--port"
+  args_type_t type;  // Type of the field
+  size_t offset;     // Offset of the field in the output struct: offsetof(config_t, port)
+  const char *value; // Default value, parsed the same way as argument value, or NULL for zero
+} args_spec_t;
+
+// Same as `args_parse_into()`, but reads arguments from `ctx`.
+args_err_t args_ctx_parse_into(const args_ctx_t *ctx, const args_spec_t *spec, size_t nspec, void *out);
+
+// Same as `args_subcommand()`, but parses arguments into `ctx`.
+int args_ctx_subcommand(args_ctx_t *ctx, int argc, char **argv, const char *const *commands, size_t ncommands);
+
+// Same as `args_unknown()` and `args_positional()`, but for `ctx`.
+const char *const *args_ctx_unknown(const args_ctx_t *ctx, size_t *count);
+const char *const *args_ctx_positional(const args_ctx_t *ctx, size_t *count);
+
+// Same as `args_parse_env()` and `args_load_file()`, but add the layer to `ctx`.
+bool args_ctx_parse_env(args_ctx_t *ctx, const char *prefix);
+bool args_ctx_load_file(args_ctx_t *ctx, const char *path);
+
+// Same as `args_serialize()` and `args_attach()`, but for `ctx`.
+size_t args_ctx_serialize(const args_ctx_t *ctx, void *buf, size_t cap);
+bool args_ctx_attach(args_ctx_t *ctx, const void *buf, size_t size);
+
+// Same as `args_register()`, `args_freeze()` and `args_classify()`, but for `ctx`.
+int args_ctx_register(args_ctx_t *ctx, const char *arg);
+bool args_ctx_freeze(args_ctx_t *ctx);
+int args_ctx_classify(const args_ctx_t *ctx, const char *token);
+int args_ctx_resolve(const args_ctx_t *ctx, const char *token);
+size_t args_ctx_abbreviate(args_ctx_t *ctx);
+args_string_view_t args_ctx_suggest(const args_ctx_t *ctx, const char *token);
+bool args_ctx_complete(const args_ctx_t *ctx);
+
+// Same as `args_complete()`, but for command line `line` with cursor at byte `point`, which is clamped to its length.
+// Writes up to `cap` bytes of the answer into `buf` and returns length of the whole answer, like `args_ctx_format()`.
+size_t args_ctx_complete_format(const args_ctx_t *ctx, const char *line, size_t point, char *buf, size_t cap);
+
+// Parse command-line arguments into the default context.
 // MUST be called before any other argument access functions.
 void args_parse(int argc, char **argv);
 
+// Same as `args_parse()`, but uses caller-owned `buf` of `cap` bytes instead of `malloc()`.
+// Returns number of bytes required. If it is greater than `cap`, the arena is too small and nothing is parsed.
+size_t args_parse_arena(int argc, char **argv, void *buf, size_t cap);
+
+// Same as `args_parse()`, but with limits and hash seed of `opts`, see `args_ctx_init_opts()`:
+//   args_parse_opts_t opts = {.max_tokens = 100000, .max_token_len = 4096, .seed = (uint32_t)getpid() ^ time(NULL)};
+//   if (args_parse_opts(argc, argv, &opts)) return 2;
+args_err_t args_parse_opts(int argc, char **argv, const args_parse_opts_t *opts);
+
+// Use instead of `args_parse()` in programs with subcommands, like `tool build|serve|gc [options]`.
+// Subcommand is the first argument, matched against `commands` of `ncommands` entries,
+// which use the same format as access functions: "rm|remove".
+// If it matches, only arguments after the subcommand are parsed, so the flags of other subcommands are never indexed
+// and `args_default_ctx()->argv[0]` is the subcommand. Call again with that `argc` and `argv` for nested ones:
+//   static const char *const commands[] = {"build", "serve", "gc"};
+//   switch (args_subcommand(argc, argv, commands, 3)) {
+//   case 0: return build(args_int("-j|--jobs"));
+//   ...
+//   }
+// Returns index of the matched command. Otherwise returns -1 and parses all of `argv`, same as `args_parse()`.
+// Commands are matched by one scan over their variants, O(total length of `commands`). A hash table or trie
+// would need the same pass to be built, and dispatch is done once, so none is kept.
+int args_subcommand(int argc, char **argv, const char *const *commands, size_t ncommands);
+
+// Free memory used by the default context.
+void args_free();
+
+// Get the default context used by functions without `ctx` parameter.
+// It is valid until the next `args_reload()`, use `args_acquire()` to read it while reloads can happen.
+const args_ctx_t *args_default_ctx();
+
 // Print command-line arguments.
+// Output is formatted into a stack buffer of `ARGS_PRINT_BUFFER` bytes and written at once,
+// with `fwrite()` or with `ARGS_WRITE(buf, len)` if it is defined.
 void args_print();
 
+// Format the same output as `args_print()` into caller-owned `buf` of `cap` bytes, terminated with '\0'.
+// Returns length of the whole output, like `snprintf()`. If it is not less than `cap`, output is truncated.
+size_t args_format(char *buf, size_t cap);
+
+// Fallback layers.
+// Arguments missing on the command line are looked up in layers added after `args_parse()`,
+// the most recently added first. Variants are matched without leading dashes, case insensitively
+// and with `_` equal to `-`, so `--max-size` matches `MAX_SIZE`.
+// Add layers before reading arguments from other threads. Adding a layer drops memoized results.
+
+// Snapshot environment variables starting with `prefix` into a layer, with the prefix removed.
+// With prefix "APP_", `args_int("-p|--port")` falls back to `APP_PORT`.
+// Variables are copied, so later changes of the environment don't affect the context.
+// Returns false if out of memory, then no layer is added and the context is unchanged.
+bool args_parse_env(const char *prefix);
+
+// Load config file `path` into a layer. Every line is read same as a `--key=value` argument:
+//   # comment
+//   port = 8080
+//   name = "John Smith"
+//   verbose
+// Blank lines and lines starting with `#` are skipped, whitespace around keys and values is trimmed.
+// Double quotes around a value are removed, for access functions of every type.
+// The file is memory mapped and its values are used in place, without copying. It counts towards `ARGS_MAX_FILES`.
+// Returns false if the file can't be read or out of memory.
+bool args_load_file(const char *path);
+
+// Snapshots.
+// A parsed context can be written into a pointer-free blob holding its index, its layers and the values of every
+// argument already converted to numbers. Processes started with the same arguments, like pre-forked workers,
+// can then attach to the blob, e.g. passed in an inherited fd or shared memory, instead of parsing again.
+// Blob is only valid for the same version of args.h and the same byte order, which attaching checks.
+
+// Write snapshot of the default context into caller-owned `buf` of `cap` bytes.
+// Returns number of bytes required. If it is greater than `cap`, nothing is written. `buf` can be NULL to get the size.
+// Returns 0 if text of the arguments doesn't fit 4 GiB.
+size_t args_serialize(void *buf, size_t cap);
+
+// Use snapshot `buf` of `size` bytes as the default context, instead of `args_parse()`.
+// `buf` must be 16 byte aligned, as memory from `mmap()` or `malloc()` is, and must outlive the context.
+// It is never written, so it can be mapped read-only. Lookups don't tokenize, hash the index or convert numbers,
+// attaching only fixes up token pointers and allocates what `args_unknown()` needs.
+// Registered flags are not part of the snapshot.
+// Returns false if `buf` is not a valid snapshot or out of memory, the default context is empty then.
+bool args_attach(const void *buf, size_t size);
+
+// Lookup statistics.
+// Collected only if `ARGS_STATS` is defined for the implementation, otherwise all counters are zero.
+// Counters are process-wide and shared by all contexts.
+
+#ifndef ARGS_STATS_KEYS
+#define ARGS_STATS_KEYS 64
+#endif // ARGS_STATS_KEYS
+
+typedef struct {
+  const char *arg;      // `arg` as passed to the access function, keyed by pointer
+  uint64_t lookups;     // Calls with this `arg`
+  uint64_t nanoseconds; // Time spent in these calls
+} args_key_stats_t;
+
+typedef struct {
+  uint64_t lookups;     // Access function calls
+  uint64_t misses;      // Lookups of arguments that are not given
+  uint64_t scanned;     // Index slots and tokens visited
+  uint64_t compares;    // Key comparisons
+  uint64_t cache_hits;  // Results returned from the lookup cache or memoized lists
+  uint64_t nanoseconds; // Time spent in access functions
+  // The most frequent keys first. Keys past the first `ARGS_STATS_KEYS` distinct ones are counted only in totals.
+  size_t nkeys;
+  args_key_stats_t keys[ARGS_STATS_KEYS];
+} args_stats_t;
+
+// Get current statistics.
+args_stats_t args_stats();
+
+// Reset all counters to zero.
+void args_stats_reset();
+
+// Print statistics, most frequent keys first.
+void args_stats_print();
+
 // Argument access functions.
 // They all accept `arg` parameter in these formats:
 // "-h", "--help", "help", or combine them as "-h|--help|help".
 // "|" symbol is used as separator to define multiple variants for a single flag.
+// If a flag is given more than once, the last occurrence wins.
+//
+// Define `ARGS_CACHE_SIZE` (number of entries, for example 64) for the implementation to memoize results
+// of scalar and string functions by `arg` pointer. Repeated calls with the same string literal then cost
+// a single probe. Readers never take a lock. `arg` strings must not be modified while the context is used.
 
 // Get boolean value of argument.
 // It will parse flags like `--help`, `--debug <value>` or `--debug=<value>`
@@ -102,20 +435,231 @@ bool args_bool(const char *arg);
 
 // Get integer value of argument.
 // It will parse flags like `--port 8080` and `--port=8080`.
+// Value is decimal or hexadecimal with `0x` prefix, optionally signed: `-42`, `0xff`.
+// Returns 0 if argument is missing, malformed or out of range.
 int args_int(const char *arg);
 
+// Same as `args_int()`, but for wider types.
+// `args_uint64()` and `args_size()` don't accept negative values.
+int64_t args_int64(const char *arg);
+uint64_t args_uint64(const char *arg);
+size_t args_size(const char *arg);
+
+// Same as integer functions above, but report why value can't be read.
+// `*out` is written only if `ARGS_OK` is returned.
+args_err_t args_int_ex(const char *arg, int *out);
+args_err_t args_int64_ex(const char *arg, int64_t *out);
+args_err_t args_uint64_ex(const char *arg, uint64_t *out);
+args_err_t args_size_ex(const char *arg, size_t *out);
+
+// Get size in bytes, like `--buffer 4K` or `--limit=2GiB`.
+// Value is decimal, optionally with a fraction, and a case insensitive suffix:
+// - none or `B`: bytes
+// - `K`, `M`, `G`, `T`, `P`, `E` and `KiB` ... `EiB`: powers of 1024
+// - `KB` ... `EB`: powers of 1000
+// Fractions are rounded to whole bytes: `1.5K` is 1536. Lone `e` is not exa, only `E`, `EB` and `EiB` are.
+// Returns 0 if argument is missing, malformed or doesn't fit into `uint64_t`.
+uint64_t args_bytes(const char *arg);
+
+// Get duration in nanoseconds, like `--timeout 250ms` or `--interval=1h30m`.
+// Value is a sequence of decimal numbers, optionally with fractions, each followed by a unit:
+// `ns`, `us` (or `µs`), `ms`, `s`, `m`, `h`, `d`. A single number without a unit is seconds.
+// Returns 0 if argument is missing, malformed or doesn't fit into `uint64_t`.
+uint64_t args_duration_ns(const char *arg);
+
+// Same as `args_bytes()` and `args_duration_ns()`, but report why value can't be read.
+// `*out` is written only if `ARGS_OK` is returned.
+args_err_t args_bytes_ex(const char *arg, uint64_t *out);
+args_err_t args_duration_ns_ex(const char *arg, uint64_t *out);
+
 // Get floating point value of argument.
 // It will parse flags like `--pi 3.14159` or `--pi=3.14159`.
+// Value is always read with `.` as decimal separator regardless of locale and is correctly rounded.
+// Exponents (`1e-5`), `inf` and `nan` are accepted.
+// Returns 0 if argument is missing or malformed.
 double args_float(const char *arg);
 
+// Same as `args_float()`, but reports why value can't be read.
+// `ARGS_ERR_RANGE` is returned if value is too large for `double`.
+// `*out` is written only if `ARGS_OK` is returned.
+args_err_t args_float_ex(const char *arg, double *out);
+
 // Get string value of argument.
 // It will parse flags in formats:
 //   --name John
 //   --name=John
 //   --name "John Smith"
 //   --name="John Smith"
+// NOTE: for `--name="John Smith"` the closing quote in `argv` is overwritten with '\0'.
 const char *args_string(const char *arg);
 
+// Get string value of argument as a slice of `argv`.
+// Same formats as `args_string()`, but quotes are stripped by adjusting the bounds,
+// so `argv` is never modified and nothing is copied.
+args_string_view_t args_string_view(const char *arg);
+
+// Get index of the value of argument in `choices`, like `--mode=safe` for choices {"fast", "balanced", "safe"}.
+// Values are compared case insensitively, ASCII only. If a choice is listed twice, the first index wins.
+// A hash table of `choices` is built on first use and kept with the context, so `choices` must stay valid and
+// unchanged until the context is freed, a static array is best.
+// Returns -1 if argument is missing or its value isn't one of `choices`.
+int args_choice(const char *arg, const char *const *choices, size_t n);
+
+// Same as `args_choice()`, but report why value can't be read.
+// `*out` is written only if `ARGS_OK` is returned.
+args_err_t args_choice_ex(const char *arg, const char *const *choices, size_t n, int *out);
+
+// List access functions.
+// They collect values of every occurrence of the argument, in command-line order, into one contiguous array
+// and store its length in `*count`. Array is owned by the context and stays valid until it is freed.
+// Repeated calls with the same `arg` pointer return the same array.
+// NULL is returned and `*count` is set to 0 if argument is missing or any value is malformed.
+// If context memory runs out, like a full arena, NULL is returned with `*count` set to the number of values.
+//
+// Define `ARGS_THREADS` (and link with `-pthread`) to convert long int and float lists on `threads` of
+// `args_parse_opts_t` at once. Values are split into chunks at commas and every thread writes its chunk straight
+// into the array. Lists shorter than `ARGS_THREADS_MIN_ITEMS` (16384 by default) are converted on the calling thread.
+
+// Get integer values of argument.
+// Values can be repeated and comma separated: `--id 1 --id=2,3` -> {1, 2, 3}.
+const int64_t *args_int_list(const char *arg, size_t *count);
+
+// Get floating point values of argument.
+// Values can be repeated and comma separated: `--w 0.5 --w=1,2.5` -> {0.5, 1, 2.5}.
+const double *args_float_list(const char *arg, size_t *count);
+
+// Get string values of argument.
+// Values can only be repeated, commas are kept: `--path a --path=b,c` -> {"a", "b,c"}.
+// Values are slices of `argv`, same as `args_string_view()`.
+const args_string_view_t *args_string_list(const char *arg, size_t *count);
+
+// Fill struct `out` with values of all options described by `spec` table of `nspec` entries,
+// in a single pass over the arguments:
+//
+//   typedef struct { int port; bool verbose; const char *name; } config_t;
+//   static const args_spec_t spec[] = {
+//     {"-p|--port", ARGS_INT, offsetof(config_t, port), "8080"},
+//     {"-v|--verbose", ARGS_BOOL, offsetof(config_t, verbose), NULL},
+//     {"-n|--name", ARGS_STRING, offsetof(config_t, name), "anonymous"},
+//   };
+//   config_t config;
+//   args_parse_into(spec, sizeof(spec) / sizeof(spec[0]), &config);
+//
+// Every field is first set to its default value. Values follow the same rules as access functions.
+// Returns the first error found. Fields with malformed values keep their defaults.
+// Spec tables of more than 32 variants take a scratch table from `ARGS_MALLOC`, freed before return.
+// Returns `ARGS_ERR_NOMEM` if it can't be allocated, then fields only have defaults and values of layers.
+args_err_t args_parse_into(const args_spec_t *spec, size_t nspec, void *out);
+
+// Leftover arguments.
+// Access functions and `args_parse_into()` mark every occurrence of the arguments they read, and the values after them,
+// as consumed. Call these after reading all options to get what is left, in command-line order.
+// Everything after a bare `--` is positional. Arguments from response files are included, layers are not.
+// Both return pointers into `argv` (or response files) in a context-owned array of `*count` entries.
+// If context memory runs out, like a full arena, NULL is returned with `*count` set to the number of arguments.
+
+// Get arguments starting with `-` that no access function has read, such as misspelled flags.
+const char *const *args_unknown(size_t *count);
+
+// Get arguments not starting with `-` that are not values of read flags, such as input files.
+const char *const *args_positional(size_t *count);
+
+// Flag registry.
+// Register every known option after `args_parse()` and call `args_freeze()` once before reading arguments
+// from other threads. Freezing builds a minimal perfect hash over all variants of registered flags,
+// so classifying a token costs one hash and one comparison.
+
+// Register option with variants in the same format as access functions: "-v|--verbose".
+// `arg` must stay valid while context is used.
+// Returns id of the flag, starting from 0, or -1 if out of memory or the registry is frozen.
+int args_register(const char *arg);
+
+// Build perfect hash of registered flags and mark every argument with id of its flag.
+// Returns false if out of memory. Arguments are still accessible then, only classification is unavailable.
+bool args_freeze();
+
+// Get id of the registered flag the key of `token` belongs to, or -1.
+// `token` can be `--flag` or `--flag=value`.
+int args_classify(const char *token);
+
+// Same as `args_classify()`, but also accept unambiguous abbreviations of long options, GNU style:
+// `--verb` is `--verbose` if no other registered flag has a variant starting with `--verb`.
+// Variants of one flag count once, so `--col` names "--color|--colour". Only prefixes starting with `--` are tried.
+// The frozen registry keeps a trie of all variants, so this is O(length of token).
+int args_resolve(const char *token);
+
+// Let access functions find abbreviated long options: after registering "-v|--verbose" and `args_freeze()`,
+// `args_bool("-v|--verbose")` is true for `--verb`. Every argument that is not a registered variant itself
+// is resolved as by `args_resolve()`, up to a bare `--`. Exact variants never cost more than before.
+// List functions see exact variants only. Call once after `args_freeze()`, before reading arguments.
+// Returns number of abbreviated arguments.
+size_t args_abbreviate();
+
+// Get registered variant closest to `token`, for "did you mean" messages about `args_unknown()`:
+// the one it abbreviates, or otherwise the nearest one within 2 edits (1 for tokens of 4 or 5 bytes, and only
+// exact matches for shorter ones, where a single edit is any other flag).
+// Returns slice of the `args_register()` string, `ptr` is NULL if none is close enough. Needs `args_freeze()`.
+args_string_view_t args_suggest(const char *token);
+
+// Answer shell completion query of bash `complete -C` or zsh `bashcompinit`, if this process is one.
+// Query is read from `COMP_LINE` and `COMP_POINT` environment variables. Word before the cursor is completed
+// with variants of registered flags starting with it, printed one per line in sorted order.
+// Words not starting with `-` and values after `=` get no answer, so the shell falls back to file names.
+// Returns true if a query was answered, then the program should exit before the rest of its startup:
+//   args_parse(argc, argv);
+//   args_register("-v|--verbose");
+//   args_register("-o|--output");
+//   if (args_complete()) return 0;
+// Enable it in bash with `complete -o default -C ./tool tool`.
+// Registry doesn't have to be frozen. Freestanding builds have no environment and always return false.
+bool args_complete();
+
+// Hot reload.
+// `args_reload()` parses a new default context and publishes it with an atomic pointer swap,
+// so long-running programs can reread their settings while other threads keep reading arguments.
+// Readers never block and see either the old or the new context. The old one is freed after a grace period,
+// once no access function is still reading it and it is not held with `args_acquire()`.
+// Pointers returned by access functions, like strings and lists, are valid only until then.
+// All other functions changing the default context, like `args_parse()`, must not run at the same time as readers.
+
+// Called on a context being reloaded before it is published, e.g. to add layers or register flags.
+typedef void (*args_setup_t)(args_ctx_t *ctx, void *data);
+
+// Parse `argc` and `argv` into a new default context, call `setup` on it if not NULL and publish it:
+//   static void setup(args_ctx_t *ctx, void *path) { args_ctx_load_file(ctx, (const char *)path); }
+//   args_reload(argc, argv, setup, (void *)"app.conf"); // On SIGHUP, from a regular thread
+// Limits, seed and threads given to `args_parse_opts()` apply to the new context too. It is allocated on the heap,
+// even if the current one was parsed with `args_parse_arena()`, use `args_reload_arena()` to stay in an arena.
+// Waits for readers of the old context to finish, so it must not be called while holding `args_acquire()`.
+// Returns false if out of memory or a limit is exceeded, the current context is kept then.
+bool args_reload(int argc, char **argv, args_setup_t setup, void *data);
+
+// Same as `args_reload()`, but the new context and all its memory are taken from caller-owned `buf` of `cap`
+// bytes, like with `args_parse_arena()`. The arena of the current context may still be read, so alternate between
+// two buffers: `buf` can be reused once the context in it has been replaced by a reload that has returned,
+// and no `args_acquire()` holds it. Returns false if `buf` is too small, it needs `sizeof(args_ctx_t) + 64` bytes
+// more than `args_ctx_init_arena()` reports.
+bool args_reload_arena(int argc, char **argv, void *buf, size_t cap, args_setup_t setup, void *data);
+
+// Hold the current default context, so that it and values read from it outlive later reloads.
+// Use with `args_ctx_*` functions, which then don't pay for reload protection on every call.
+const args_ctx_t *args_acquire();
+
+// Release context returned by `args_acquire()`.
+void args_release(const args_ctx_t *ctx);
+
+// Read the current default context with the same protection access functions use:
+//   unsigned reader;
+//   const args_ctx_t *ctx = args_read_begin(&reader);
+//   int port = args_ctx_int(ctx, "--port");
+//   args_read_end(reader);
+// Unlike `args_acquire()`, which updates one counter shared by all threads, this touches a counter of a shard
+// picked per thread, so readers on different threads don't write the same cache line.
+// Values read stay valid as long as those of access functions, until a grace period after a reload.
+// `args_reload()` waits for the read to end, so keep it short and don't reload in between.
+const args_ctx_t *args_read_begin(unsigned *reader);
+void args_read_end(unsigned reader);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -124,163 +668,3500 @@ const char *args_string(const char *arg);
 
 #ifdef ARGS_IMPLEMENTATION
 
-#include <ctype.h>
-#include <stddef.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+
+// Define `ARGS_FREESTANDING` for static or minimal binaries: only `<string.h>` is used from libc.
+// There is no stdio, malloc, locale, environment or file access then:
+// - heap memory comes from a static buffer of `ARGS_STATIC_HEAP_SIZE` bytes, unless `ARGS_MALLOC` and `ARGS_FREE`
+//   are defined. Freed memory is reused only from the end, as scratch memory and the last context freed are.
+//   Arenas work as usual.
+// - `args_print()` outputs through `ARGS_WRITE(buf, len)`, for example `write(1, buf, len)`, or nothing.
+// - response files, config files and environment layers are not available.
+#ifndef ARGS_FREESTANDING
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
-static int args__argc;
-static char **args__argv;
+#if defined(__unix__) || defined(__APPLE__)
+#define ARGS__MMAP
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-void args_parse(int argc, char **argv) {
-  args__argc = argc;
-  args__argv = argv;
+#if defined(MAP_ANONYMOUS)
+#define ARGS__MAP_ANON MAP_ANONYMOUS
+#elif defined(MAP_ANON)
+#define ARGS__MAP_ANON MAP_ANON
+#endif
+#endif
+
+#ifdef _WIN32
+#define ARGS__ENVIRON _environ
+#else
+extern char **environ;
+#define ARGS__ENVIRON environ
+#endif
+
+#ifdef ARGS_THREADS
+#define ARGS__THREADS
+#include <pthread.h>
+#endif
+#endif // ARGS_FREESTANDING
+
+// Tokens are classified 8 to 32 bytes at a time. Define `ARGS_NO_SIMD` to use the portable scalar code.
+#if !defined(ARGS_NO_SIMD) && defined(__AVX2__)
+#define ARGS__AVX2
+#include <immintrin.h>
+#elif !defined(ARGS_NO_SIMD) && defined(__SSE2__)
+#define ARGS__SSE2
+#include <emmintrin.h>
+#elif !defined(ARGS_NO_SIMD) && defined(__ARM_NEON) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define ARGS__NEON
+#include <arm_neon.h>
+#endif
+
+// Alignment of every allocation made from context memory
+#define ARGS__ALIGN 16
+
+#if defined(ARGS_FREESTANDING) && !defined(ARGS_MALLOC)
+#ifndef ARGS_STATIC_HEAP_SIZE
+#define ARGS_STATIC_HEAP_SIZE 65536
+#endif // ARGS_STATIC_HEAP_SIZE
+
+static unsigned char args__static_heap[ARGS_STATIC_HEAP_SIZE] __attribute__((aligned(ARGS__ALIGN)));
+static size_t args__static_heap_used;
+
+// Bump allocator over `args__static_heap`, safe to call from many threads.
+// Every block is preceded by its size, so that the most recent one can be given back.
+static void *args__static_malloc(size_t size) {
+  size = ARGS__ALIGN + ((size + ARGS__ALIGN - 1) & ~(size_t)(ARGS__ALIGN - 1));
+  size_t used = __atomic_load_n(&args__static_heap_used, __ATOMIC_RELAXED);
+  do {
+    if (size > ARGS_STATIC_HEAP_SIZE - used) return NULL;
+  } while (!__atomic_compare_exchange_n(&args__static_heap_used, &used, used + size, false, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED));
+  memcpy(args__static_heap + used, &size, sizeof(size));
+  return args__static_heap + used + ARGS__ALIGN;
 }
 
-void args_print() {
-  for (size_t i = 0; i < args__argc; ++i) printf("Argument %zu: %s\n", i, args__argv[i]);
-}
-
-bool args_bool(const char *arg) {
-  static const char *true_values[] = {"true", "on", "yes", "y", "1"};
-  static const char *false_values[] = {"false", "off", "no", "n", "0"};
-  // Copy argument
-  char arg_copy[strlen(arg) + 1];
-  strcpy(arg_copy, arg);
-  // Start parsing
-  char *flag;
-  flag = strtok(arg_copy, "|");
-  while (flag) {
-    for (size_t i = 1; i < args__argc; ++i) {
-      // Check if arg is just a `--flag`
-      if (!strcmp(args__argv[i], flag)) {
-        // Check if next argument is in true_values or false_values
-        if (i + 1 < args__argc) {
-          // Check for true values
-          const char *next_arg = args__argv[i + 1];
-          for (size_t j = 0; j < sizeof(true_values) / sizeof(true_values[0]); ++j)
-            if (!strcasecmp(next_arg, true_values[j])) return true;
-          // Check for false values
-          for (size_t j = 0; j < sizeof(false_values) / sizeof(false_values[0]); ++j)
-            if (!strcasecmp(next_arg, false_values[j])) return false;
-        }
-        return true;
-      }
-      // Check if arg is `--flag=<value>`
-      if (!strncmp(args__argv[i], flag, strlen(flag))) {
-        const char *value = strchr(args__argv[i], '=');
-        if (value) {
-          value++; // Move past the '=' character
-          // Check for true values
-          for (size_t j = 0; j < sizeof(true_values) / sizeof(true_values[0]); j++)
-            if (!strcmp(value, true_values[j])) return true;
-          // Check for false values
-          for (size_t j = 0; j < sizeof(false_values) / sizeof(false_values[0]); j++)
-            if (!strcmp(value, false_values[j])) return false;
-        }
-      }
+// Give back block of `args__static_malloc()` if nothing was allocated after it, otherwise keep it.
+// Scratch tables and blocks of the last context freed are, so they don't use up the heap.
+static void args__static_free(void *ptr) {
+  if (!ptr) return;
+  unsigned char *block = (unsigned char *)ptr - ARGS__ALIGN;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  size_t end = (size_t)(block - args__static_heap) + size;
+  __atomic_compare_exchange_n(&args__static_heap_used, &end, end - size, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+#define ARGS_MALLOC(size) args__static_malloc(size)
+#define ARGS_FREE(ptr)    args__static_free(ptr)
+#endif // ARGS_FREESTANDING
+
+#ifndef ARGS_MALLOC
+#define ARGS_MALLOC(size) malloc(size)
+#endif // ARGS_MALLOC
+
+#ifndef ARGS_FREE
+#define ARGS_FREE(ptr) free(ptr)
+#endif // ARGS_FREE
+
+#ifdef ARGS_FREESTANDING
+static void args__swap(unsigned char *a, unsigned char *b, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    unsigned char t = a[i];
+    a[i] = b[i];
+    b[i] = t;
+  }
+}
+
+// Heapsort in place of `qsort()`.
+static void args__sort(void *base, size_t n, size_t size, int (*compare)(const void *, const void *)) {
+  unsigned char *a = (unsigned char *)base;
+  for (size_t start = n / 2, end = n; end > 1;) {
+    size_t root;
+    if (start) root = --start;
+    else {
+      args__swap(a, a + --end * size, size);
+      root = 0;
+    }
+    // Sift down
+    for (size_t child; (child = 2 * root + 1) < end; root = child) {
+      if (child + 1 < end && compare(a + child * size, a + (child + 1) * size) < 0) child++;
+      if (compare(a + root * size, a + child * size) >= 0) break;
+      args__swap(a + root * size, a + child * size, size);
     }
-    flag = strtok(NULL, "|");
   }
-  return false;
 }
+#else
+#define args__sort qsort
+#endif // ARGS_FREESTANDING
 
-int args_int(const char *arg) {
-  // Copy argument
-  char arg_copy[strlen(arg) + 1];
-  strcpy(arg_copy, arg);
-  // Start parsing
-  int result = 0;
-  char *flag;
-  flag = strtok(arg_copy, "|");
-  while (flag) {
-    for (size_t i = 1; i < args__argc; ++i) {
-      // Check if arg is `--flag`
-      if (!strcmp(args__argv[i], flag)) {
-        // Check if next argument is number
-        if (i + 1 < args__argc && isdigit(args__argv[i + 1][0])) result = atoi(args__argv[i + 1]);
-      } else {
-        // Check if arg is `--flag=<value>`
-        if (!strncmp(args__argv[i], flag, strlen(flag))) {
-          const char *value = strchr(args__argv[i], '=');
-          if (value) {
-            value++; // Move past the '=' character
-            result = atoi(value);
-          }
-        }
-      }
+#ifndef ARGS_PRINT_BUFFER
+#define ARGS_PRINT_BUFFER 4096
+#endif // ARGS_PRINT_BUFFER
+
+// Buffered output. A full buffer is passed to `args__write()` if `flush` is set, otherwise the rest is only counted.
+typedef struct {
+  char *buf;
+  size_t cap;
+  size_t len;   // Bytes in `buf`
+  size_t total; // All bytes put so far
+  bool flush;
+} args__out_t;
+
+static void args__write(const char *buf, size_t len) {
+#if defined(ARGS_WRITE)
+  ARGS_WRITE(buf, len);
+#elif !defined(ARGS_FREESTANDING)
+  // Through stdio, so that output stays ordered with the program's own `printf()`
+  fwrite(buf, 1, len, stdout);
+#else
+  (void)buf, (void)len;
+#endif
+}
+
+static void args__put(args__out_t *out, const char *s, size_t n) {
+  out->total += n;
+  while (n) {
+    if (out->len == out->cap) {
+      if (!out->flush || !out->cap) return;
+      args__write(out->buf, out->len);
+      out->len = 0;
     }
-    flag = strtok(NULL, "|");
+    size_t k = n < out->cap - out->len ? n : out->cap - out->len;
+    memcpy(out->buf + out->len, s, k);
+    out->len += k;
+    s += k;
+    n -= k;
   }
-  return result;
 }
 
-double args_float(const char *arg) {
-  // Copy argument
-  char arg_copy[strlen(arg) + 1];
-  strcpy(arg_copy, arg);
-  // Start parsing
-  double result = 0;
-  char *flag;
-  flag = strtok(arg_copy, "|");
-  while (flag) {
-    for (size_t i = 1; i < args__argc; ++i)
-      // Check if arg is `--flag`
-      if (!strcmp(args__argv[i], flag)) {
-        // Check if next argument is number
-        if (i + 1 < args__argc && isdigit(args__argv[i + 1][0])) result = atof(args__argv[i + 1]);
-      } else {
-        // Check if arg is `--flag=<value>`
-        if (!strncmp(args__argv[i], flag, strlen(flag))) {
-          const char *value = strchr(args__argv[i], '=');
-          if (value) {
-            value++; // Move past the '=' character
-            result = atof(value);
-          }
-        }
+static void args__put_str(args__out_t *out, const char *s) { args__put(out, s, strlen(s)); }
+
+// Put `value` right aligned to `width` characters.
+static void args__put_uint(args__out_t *out, uint64_t value, int width) {
+  char digits[24];
+  int n = 0;
+  do digits[sizeof(digits) - ++n] = (char)('0' + value % 10);
+  while (value /= 10);
+  for (; width > n; --width) args__put(out, " ", 1);
+  args__put(out, digits + sizeof(digits) - n, n);
+}
+
+// Atomics for state shared between readers of a context
+#define ARGS__LOAD(ptr)                  __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ARGS__CAS(ptr, expected, desired) \
+  __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#ifdef ARGS_STATS
+#ifndef ARGS_FREESTANDING
+#include <time.h>
+#endif // ARGS_FREESTANDING
+
+static args_stats_t args__stats;
+
+#define ARGS__STATS_ADD(field, n) __atomic_fetch_add(&args__stats.field, n, __ATOMIC_RELAXED)
+#define ARGS__STATS_BEGIN()       uint64_t args__stats_start = args__now()
+#define ARGS__STATS_END(arg)      args__stats_lookup(arg, args__stats_start)
+#else
+#define ARGS__STATS_ADD(field, n) ((void)0)
+#define ARGS__STATS_BEGIN()
+#define ARGS__STATS_END(arg) ((void)0)
+#endif // ARGS_STATS
+
+// Heap allocations of a context are chained, so they can be freed at once.
+// Header is padded to `ARGS__ALIGN` bytes.
+typedef struct args__block {
+  struct args__block *next;
+} args__block_t;
+
+// Every argv token is split once into a key and a value:
+//   `--flag=value` -> key `--flag`, value `value`
+//   `--flag`       -> key `--flag`, value is the next token (or NULL)
+typedef struct args__token {
+  const char *key;           // Start of the token
+  size_t key_len;            // Length of the key, up to (not including) `=`
+  size_t len;                // Length of the whole token
+  const char *value;         // Value slice, NULL if there is none
+  size_t value_len;          // Length of the value
+  args_string_view_t string; // Value without the quotes of `--flag="multi word value"`
+  bool has_eq;               // Value came from `--flag=value`
+  int prev;                  // Index of the previous token with the same key, or -1
+  uint32_t hash;             // Hash of the key
+  int flag;                  // Id of the registered flag of the key, or -1
+  int value_token;           // Index of the token holding the value of `--flag <value>`, or -1
+  int source;                // Index of the cluster `-abc` this short flag was decoded from, or -1
+} args__token_t;
+
+// Open-addressing hash slot. `token` is the index of the LAST occurrence of the key, or -1 if the slot is empty.
+typedef struct args__slot {
+  uint32_t hash;
+  int token;
+} args__slot_t;
+
+// Variant of a registered flag abbreviated on the command line, in open-addressing table `entries`.
+// `prev` links every abbreviating argument to the previous one of the same flag, see `args_abbreviate()`.
+typedef struct {
+  const char *name; // NULL if the entry is empty
+  size_t len;
+  uint32_t hash;
+  int token;           // Last argument abbreviating the flag
+  unsigned char walked; // Bit `1 << use` is set once all abbreviating arguments are consumed for that use
+} args__abbrev_t;
+
+typedef struct args__abbrevs {
+  args__abbrev_t *entries;
+  size_t mask;
+  int *prev;
+} args__abbrevs_t;
+
+// Values of a token converted ahead of time, for contexts attached to a snapshot
+typedef struct args__value {
+  int64_t i64;
+  uint64_t u64;
+  double f64;
+  uint8_t i64_err; // `args_err_t` of each conversion
+  uint8_t u64_err;
+  uint8_t f64_err;
+} args__value_t;
+
+// Fallback source of arguments with its own index.
+// Keys are stored without leading dashes and folded with `args__fold()`.
+typedef struct args__layer {
+  struct args__layer *next; // Layer with lower priority
+  args__token_t *tokens;
+  size_t ntokens;
+  args__slot_t *slots;
+  size_t slots_mask;
+  const args__value_t *values; // Converted values of a snapshot, or NULL
+} args__layer_t;
+
+// Default context with the number of its references, minus one.
+// Being current is one reference, `args_acquire()` adds others.
+typedef struct args__snapshot {
+  args_ctx_t ctx;
+  size_t refs;
+  bool heap; // Allocated by `args_reload()`, not static or in an arena of `args_reload_arena()`
+} args__snapshot_t;
+
+// Initial snapshot is static, later ones are made by `args_reload()`
+static args__snapshot_t args__static;
+static args__snapshot_t *args__current = &args__static;
+
+// Options of `args_parse_opts()`, reused by reloads
+static args_parse_opts_t args__opts;
+
+// FNV-1a
+static uint32_t args__hash(const char *s, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i) h = (h ^ (unsigned char)s[i]) * 16777619u;
+  return h;
+}
+
+// Keyed hash of seeded indexes. It is not cryptographic, but keys can't be made to collide without the seed.
+static uint32_t args__hash_seeded(const char *s, size_t len, uint32_t seed) {
+  uint64_t h = (seed | (uint64_t)seed << 32) ^ (len * 0x9E3779B97F4A7C15ull), w;
+  for (; len >= 8; s += 8, len -= 8) {
+    memcpy(&w, s, 8);
+    h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+  }
+  w = 0;
+  memcpy(&w, s, len);
+  h = (h ^ w) * 0x94D049BB133111EBull;
+  h ^= h >> 29;
+  h *= 0xBF58476D1CE4E5B9ull;
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+// First slot to probe for `key` with FNV-1a `hash`. Slots still store `hash`, only their position depends on `seed`.
+static size_t args__slot_start(const char *key, size_t len, uint32_t hash, uint32_t seed) {
+  return seed ? args__hash_seeded(key, len, seed) : hash;
+}
+
+// Reentrant replacement for `strtok(spec, "|")`.
+// Returns start of the next variant in `*spec` and stores its length in `*len`, or NULL if there are no more.
+static const char *args__next_alias(const char **spec, size_t *len) {
+  const char *p = *spec;
+  while (*p == '|') p++;
+  if (!*p) return NULL;
+  const char *start = p;
+  while (*p && *p != '|') p++;
+  *len = p - start;
+  *spec = p;
+  return start;
+}
+
+#ifdef ARGS_STATS
+static uint64_t args__now() {
+#ifdef ARGS_FREESTANDING
+  // No clock, only counters are collected
+  return 0;
+#else
+  struct timespec ts;
+#if defined(__unix__) || defined(__APPLE__)
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+  timespec_get(&ts, TIME_UTC);
+#endif
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif // ARGS_FREESTANDING
+}
+
+// Count a finished access function call. Per key counters live in an open-addressing table keyed by pointer.
+static void args__stats_lookup(const char *arg, uint64_t start) {
+  uint64_t ns = args__now() - start;
+  ARGS__STATS_ADD(lookups, 1);
+  ARGS__STATS_ADD(nanoseconds, ns);
+  if (!arg) return;
+  size_t i = ((uintptr_t)arg >> 3) * 0x9E3779B9u % ARGS_STATS_KEYS;
+  for (size_t n = 0; n < ARGS_STATS_KEYS; ++n, i = (i + 1) % ARGS_STATS_KEYS) {
+    args_key_stats_t *key = &args__stats.keys[i];
+    const char *expected = NULL;
+    if (ARGS__LOAD(&key->arg) != arg && !ARGS__CAS(&key->arg, &expected, arg) && expected != arg) continue;
+    __atomic_fetch_add(&key->lookups, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&key->nanoseconds, ns, __ATOMIC_RELAXED);
+    return;
+  }
+}
+#endif // ARGS_STATS
+
+// Find index of the last token with the given key, or -1.
+static int args__find(const args_ctx_t *ctx, const char *key, size_t len, uint32_t hash) {
+  if (!ctx->slots) return -1;
+  int found = -1;
+  size_t i = args__slot_start(key, len, hash, ctx->seed) & ctx->slots_mask, scanned = 1, compares = 0;
+  for (;; i = (i + 1) & ctx->slots_mask, scanned++) {
+    const args__slot_t *slot = &ctx->slots[i];
+    if (slot->token < 0) break;
+    if (slot->hash != hash) continue;
+    compares++;
+    const args__token_t *tok = &ctx->tokens[slot->token];
+    if (tok->key_len == len && !memcmp(tok->key, key, len)) {
+      found = slot->token;
+      break;
+    }
+  }
+  ARGS__STATS_ADD(scanned, scanned);
+  ARGS__STATS_ADD(compares, compares);
+  (void)scanned, (void)compares;
+  return found;
+}
+
+static unsigned char args__lower(char c) { return c >= 'A' && c <= 'Z' ? (unsigned char)(c | 0x20) : (unsigned char)c; }
+
+// Compare `s` of `len` bytes to C string `other` ignoring case.
+// ASCII only, unlike `strcasecmp()` it doesn't depend on locale.
+static bool args__equal_nocase(const char *s, size_t len, const char *other) {
+  for (size_t i = 0; i < len; ++i)
+    if (!other[i] || args__lower(s[i]) != args__lower(other[i])) return false;
+  return !other[len];
+}
+
+// FNV-1a of lowercase `s`
+static uint32_t args__hash_nocase(const char *s, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i) h = (h ^ args__lower(s[i])) * 16777619u;
+  return h;
+}
+
+// Case insensitive hash table of a choice set. `slots` map hashes to indexes of `choices`.
+typedef struct args__choices {
+  const char *const *choices;
+  size_t n;
+  size_t mask;
+  args__slot_t *slots;
+  struct args__choices *next;
+} args__choices_t;
+
+// Number of slots for `n` choices, at most half of them are taken
+static size_t args__choices_slots(size_t n) {
+  size_t nslots = 2;
+  while (nslots < 2 * n) nslots <<= 1;
+  return nslots;
+}
+
+// Index of `s` in `set`, or -1.
+static int args__choices_find(const args__choices_t *set, const char *s, size_t len) {
+  uint32_t hash = args__hash_nocase(s, len);
+  for (size_t i = hash & set->mask; set->slots[i].token >= 0; i = (i + 1) & set->mask)
+    if (set->slots[i].hash == hash && args__equal_nocase(s, len, set->choices[set->slots[i].token]))
+      return set->slots[i].token;
+  return -1;
+}
+
+// Fill `set` with `choices`, `slots` has `args__choices_slots(n)` entries.
+static void args__choices_build(args__choices_t *set, const char *const *choices, size_t n, args__slot_t *slots) {
+  set->choices = choices;
+  set->n = n;
+  set->mask = args__choices_slots(n) - 1;
+  set->slots = slots;
+  set->next = NULL;
+  for (size_t i = 0; i <= set->mask; ++i) slots[i] = (args__slot_t){0, -1};
+  for (size_t c = 0; c < n; ++c) {
+    size_t len = strlen(choices[c]);
+    if (args__choices_find(set, choices[c], len) >= 0) continue;
+    uint32_t hash = args__hash_nocase(choices[c], len);
+    size_t i = hash & set->mask;
+    while (slots[i].token >= 0) i = (i + 1) & set->mask;
+    slots[i] = (args__slot_t){hash, (int)c};
+  }
+}
+
+// Linear search for when a table can't be allocated.
+static int args__choices_scan(const char *const *choices, size_t n, const char *s, size_t len) {
+  for (size_t c = 0; c < n; ++c)
+    if (args__equal_nocase(s, len, choices[c])) return (int)c;
+  return -1;
+}
+
+// Boolean words, true ones have odd indexes
+static const char *const args__bool_words[] = {"false", "true", "off", "on", "no", "yes", "n", "y", "0", "1"};
+#define ARGS__BOOL_WORDS (sizeof(args__bool_words) / sizeof(args__bool_words[0]))
+
+// Table of boolean words, built by the first caller. `args__bool_state` is 0 until then, 1 while building and 2 after.
+static args__slot_t args__bool_slots[32];
+static args__choices_t args__bool_set;
+static uint32_t args__bool_state;
+
+// Returns 1 for true values, 0 for false values and -1 otherwise. Case insensitive.
+static int args__bool_word(const char *s, size_t len) {
+  uint32_t state = __atomic_load_n(&args__bool_state, __ATOMIC_ACQUIRE);
+  if (!state && ARGS__CAS(&args__bool_state, &state, 1)) {
+    args__choices_build(&args__bool_set, args__bool_words, ARGS__BOOL_WORDS, args__bool_slots);
+    state = 2;
+    __atomic_store_n(&args__bool_state, state, __ATOMIC_RELEASE);
+  }
+  // Others scan while the table is being built
+  int i = state == 2 ? args__choices_find(&args__bool_set, s, len)
+                     : args__choices_scan(args__bool_words, ARGS__BOOL_WORDS, s, len);
+  return i < 0 ? -1 : i & 1;
+}
+
+// How access functions use tokens they find
+typedef enum {
+  ARGS__USE_FLAG,  // Boolean, next token is its value only if it is a boolean word
+  ARGS__USE_VALUE, // Next token is always the value
+} args__use_t;
+
+// Consumed bitmap of tokens is followed by a bitmap per use, of last occurrences whose chain is consumed
+#define ARGS__BITMAPS 3
+
+static void args__mark(const args_ctx_t *ctx, size_t i) {
+  uint64_t bit = 1ull << (i & 63), *word = &ctx->consumed[i >> 6];
+  if (!(__atomic_load_n(word, __ATOMIC_RELAXED) & bit)) __atomic_fetch_or(word, bit, __ATOMIC_RELAXED);
+}
+
+static bool args__marked(const args_ctx_t *ctx, size_t i) {
+  return ctx->consumed && (__atomic_load_n(&ctx->consumed[i >> 6], __ATOMIC_RELAXED) >> (i & 63)) & 1;
+}
+
+// Mark token `i` and its value as consumed.
+static void args__consume(const args_ctx_t *ctx, size_t i, args__use_t use) {
+  if (!ctx->consumed) return;
+  const args__token_t *tok = &ctx->tokens[i];
+  args__mark(ctx, i);
+  if (tok->value_token < 0 || (use == ARGS__USE_FLAG && args__bool_word(tok->value, tok->value_len) < 0)) return;
+  args__mark(ctx, (size_t)tok->value_token);
+}
+
+// Mark all occurrences of a key, starting from the last one.
+// Chain is walked once per use, later lookups of the key only test a bit. Value use marks more than flag use.
+static void args__consume_chain(const args_ctx_t *ctx, int last, args__use_t use) {
+  if (last < 0 || !ctx->consumed) return;
+  size_t words = (ctx->ntokens + 63) / 64;
+  uint64_t bit = 1ull << (last & 63), *value = &ctx->consumed[words + (last >> 6)], *flag = value + words;
+  uint64_t done = __atomic_load_n(value, __ATOMIC_RELAXED);
+  if (use == ARGS__USE_FLAG) done |= __atomic_load_n(flag, __ATOMIC_RELAXED);
+  if (done & bit) return;
+  for (int i = last; i >= 0; i = ctx->tokens[i].prev) args__consume(ctx, i, use);
+  __atomic_fetch_or(use == ARGS__USE_VALUE ? value : flag, bit, __ATOMIC_RELAXED);
+}
+
+// Key character as it is stored in layers.
+static char args__fold(char c) { return c == '_' ? '-' : (c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c); }
+
+// Find index of the last token of `layer` matching `key`, or -1.
+static int args__layer_find(const args__layer_t *layer, const char *key, size_t len) {
+  while (len && *key == '-') key++, len--;
+  if (!len) return -1;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; ++i) hash = (hash ^ (unsigned char)args__fold(key[i])) * 16777619u;
+  for (size_t i = hash & layer->slots_mask;; i = (i + 1) & layer->slots_mask) {
+    const args__slot_t *slot = &layer->slots[i];
+    if (slot->token < 0) return -1;
+    const args__token_t *tok = &layer->tokens[slot->token];
+    if (slot->hash != hash || tok->key_len != len) continue;
+    size_t j = 0;
+    while (j < len && args__fold(key[j]) == tok->key[j]) j++;
+    if (j == len) return slot->token;
+  }
+}
+
+// Find the last token matching any variant of `arg` in the first layer that has one, or NULL.
+static const args__token_t *args__layers_lookup(const args_ctx_t *ctx, const char *arg) {
+  for (const args__layer_t *layer = ctx->layers; layer; layer = layer->next) {
+    int found = -1;
+    const char *spec = arg, *flag;
+    size_t len;
+    while ((flag = args__next_alias(&spec, &len))) {
+      int i = args__layer_find(layer, flag, len);
+      if (i > found) found = i;
+    }
+    if (found >= 0) return &layer->tokens[found];
+  }
+  return NULL;
+}
+
+// Find the last argument abbreviating variant `key`, or -1. All of them are consumed.
+static int args__abbrev_find(const args_ctx_t *ctx, const char *key, size_t len, uint32_t hash, args__use_t use) {
+  const args__abbrevs_t *abbrevs = ctx->abbrevs;
+  for (size_t i = hash & abbrevs->mask; abbrevs->entries[i].name; i = (i + 1) & abbrevs->mask) {
+    const args__abbrev_t *entry = &abbrevs->entries[i];
+    if (entry->hash != hash || entry->len != len || memcmp(entry->name, key, len)) continue;
+    unsigned char *walked = (unsigned char *)&entry->walked, done = __atomic_load_n(walked, __ATOMIC_RELAXED);
+    if (!(done & (1 << ARGS__USE_VALUE)) && !(done & (1 << use))) {
+      for (int t = entry->token; t >= 0; t = abbrevs->prev[t]) args__consume(ctx, (size_t)t, use);
+      __atomic_fetch_or(walked, (unsigned char)(1 << use), __ATOMIC_RELAXED);
+    }
+    return entry->token;
+  }
+  return -1;
+}
+
+// Find the last token matching any of the `|` separated variants in `arg`, or NULL.
+// Command line comes first, then layers. All occurrences on the command line are consumed.
+static const args__token_t *args__lookup(const args_ctx_t *ctx, const char *arg, args__use_t use) {
+  // Pick the occurrence that comes last on the command line
+  int found = -1;
+  const char *spec = arg, *flag;
+  size_t len;
+  while ((flag = args__next_alias(&spec, &len))) {
+    uint32_t hash = args__hash(flag, len);
+    int i = args__find(ctx, flag, len, hash);
+    args__consume_chain(ctx, i, use);
+    if (i > found) found = i;
+    if (ctx->abbrevs && (i = args__abbrev_find(ctx, flag, len, hash, use)) > found) found = i;
+  }
+  if (found >= 0) return &ctx->tokens[found];
+  const args__token_t *tok = ctx->layers ? args__layers_lookup(ctx, arg) : NULL;
+  if (!tok) ARGS__STATS_ADD(misses, 1);
+  return tok;
+}
+
+// Same as `args__lookup()`, but with precomputed variants.
+static const args__token_t *args__lookup_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys,
+                                              args__use_t use) {
+  int found = -1;
+  for (size_t k = 0; k < nkeys; ++k) {
+    int i = args__find(ctx, keys[k].name, keys[k].len, keys[k].hash);
+    args__consume_chain(ctx, i, use);
+    if (i > found) found = i;
+    if (ctx->abbrevs && (i = args__abbrev_find(ctx, keys[k].name, keys[k].len, keys[k].hash, use)) > found) found = i;
+  }
+  if (found >= 0) return &ctx->tokens[found];
+  for (const args__layer_t *layer = ctx->layers; layer; layer = layer->next) {
+    for (size_t k = 0; k < nkeys; ++k) {
+      int i = args__layer_find(layer, keys[k].name, keys[k].len);
+      if (i > found) found = i;
+    }
+    if (found >= 0) return &layer->tokens[found];
+  }
+  ARGS__STATS_ADD(misses, 1);
+  return NULL;
+}
+
+// Get value of token found by lookup.
+static args_err_t args__value(const args__token_t *tok, const char **value, size_t *len) {
+  if (!tok) return ARGS_ERR_MISSING;
+  if (!tok->value) return ARGS_ERR_INVALID;
+  *value = tok->value;
+  *len = tok->value_len;
+  return ARGS_OK;
+}
+
+// Check that all 8 bytes of `v` are ASCII digits.
+static bool args__is_8digits(uint64_t v) {
+  return ((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+         0x3333333333333333ull;
+}
+
+// Convert 8 ASCII digits to a number at once, first digit in the lowest byte.
+static uint32_t args__parse_8digits(uint64_t v) {
+  v -= 0x3030303030303030ull;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+       (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >>
+      32;
+  return (uint32_t)v;
+}
+
+// Parse unsigned decimal or `0x` hexadecimal number without sign.
+static args_err_t args__parse_u64(const char *s, size_t len, uint64_t *out) {
+  uint64_t result = 0;
+  size_t i = 0;
+  if (len > 2 && s[0] == '0' && (s[1] | 0x20) == 'x') {
+    for (i = 2; i < len; ++i) {
+      unsigned digit = (unsigned char)s[i] - '0';
+      if (digit > 9) {
+        digit = ((unsigned char)s[i] | 0x20) - 'a';
+        if (digit > 5) return ARGS_ERR_INVALID;
+        digit += 10;
       }
-    flag = strtok(NULL, "|");
+      if (result >> 60) return ARGS_ERR_RANGE;
+      result = (result << 4) | digit;
+    }
+    *out = result;
+    return ARGS_OK;
   }
-  return result;
+  if (!len) return ARGS_ERR_INVALID;
+  // Take 8 digits at a time
+  for (; len - i >= 8; i += 8) {
+    uint64_t v;
+    memcpy(&v, s + i, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    if (!args__is_8digits(v)) break;
+    uint32_t chunk = args__parse_8digits(v);
+    if (result > (UINT64_MAX - chunk) / 100000000) return ARGS_ERR_RANGE;
+    result = result * 100000000 + chunk;
+  }
+  for (; i < len; ++i) {
+    unsigned digit = (unsigned char)s[i] - '0';
+    if (digit > 9) return ARGS_ERR_INVALID;
+    if (result > (UINT64_MAX - digit) / 10) return ARGS_ERR_RANGE;
+    result = result * 10 + digit;
+  }
+  *out = result;
+  return ARGS_OK;
 }
 
-const char *args_string(const char *arg) {
-  // Copy argument
-  char arg_copy[strlen(arg) + 1];
-  strcpy(arg_copy, arg);
-  // Start parsing
-  const char *result = NULL;
-  char *flag;
-  flag = strtok(arg_copy, "|");
-  while (flag) {
-    for (size_t i = 1; i < args__argc; ++i) {
-      // Check if arg is `--flag <value>` and has next arg
-      if (!strcmp(args__argv[i], flag) && i + 1 < args__argc) result = args__argv[i + 1];
-      else {
-        // Check if arg is `--flag=value`
-        if (!strncmp(args__argv[i], flag, strlen(flag))) {
-          char *value = strchr(args__argv[i], '=');
-          if (value) {
-            value++; // Move past the '=' character
-            // Value is `--flag="multi word value"`
-            if (value[0] == '"') {
-              value++; // Move past the '"' character
-              const char *start = value;
-              result = start;
-              while (!(*value == '"' || *value == '\0')) value++;
-              *value = '\0';
-            }
-            // Value is `--flag=value`
-            else
-              result = value;
-          }
-        }
+static args_err_t args__parse_i64(const char *s, size_t len, int64_t *out) {
+  bool negative = len && s[0] == '-';
+  if (len && (s[0] == '-' || s[0] == '+')) s++, len--;
+  uint64_t magnitude;
+  args_err_t err = args__parse_u64(s, len, &magnitude);
+  if (err) return err;
+  if (magnitude > (uint64_t)INT64_MAX + negative) return ARGS_ERR_RANGE;
+  *out = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+  return ARGS_OK;
+}
+
+static args_err_t args__parse_unsigned(const char *s, size_t len, uint64_t *out) {
+  if (len && s[0] == '-') {
+    // Allow only `-0`
+    uint64_t magnitude;
+    args_err_t err = args__parse_u64(s + 1, len - 1, &magnitude);
+    if (err || magnitude) return err ? err : ARGS_ERR_RANGE;
+    *out = 0;
+    return ARGS_OK;
+  }
+  if (len && s[0] == '+') s++, len--;
+  return args__parse_u64(s, len, out);
+}
+
+// Max number of significant digits kept for exact float conversion.
+// Digits after that only affect rounding of exact halfway cases, which is tracked with `trunc`.
+#define ARGS__DECIMAL_DIGITS 800
+
+// Arbitrary precision decimal 0.d[0]d[1]...d[nd-1] * 10^dp, used when the fast path can't be exact.
+// Extra 20 digits are head room for left shifts.
+typedef struct {
+  uint8_t d[ARGS__DECIMAL_DIGITS + 20];
+  int nd;
+  int dp;
+  bool trunc;
+} args__decimal_t;
+
+static void args__decimal_trim(args__decimal_t *a) {
+  while (a->nd > 0 && a->d[a->nd - 1] == 0) a->nd--;
+  if (a->nd == 0) a->dp = 0;
+}
+
+// Multiply by 2^k, k <= 60.
+static void args__decimal_lshift(args__decimal_t *a, unsigned k) {
+  // Write digits from the right into head room, then move them to the front
+  int w = a->nd + 20;
+  uint64_t n = 0;
+  for (int r = a->nd - 1; r >= 0; --r) {
+    n += (uint64_t)a->d[r] << k;
+    a->d[--w] = n % 10;
+    n /= 10;
+  }
+  while (n) {
+    a->d[--w] = n % 10;
+    n /= 10;
+  }
+  int nd = a->nd + 20 - w;
+  memmove(a->d, a->d + w, nd);
+  a->dp += nd - a->nd;
+  a->nd = nd;
+  if (a->nd > ARGS__DECIMAL_DIGITS) {
+    for (int i = ARGS__DECIMAL_DIGITS; i < a->nd; ++i)
+      if (a->d[i]) a->trunc = true;
+    a->nd = ARGS__DECIMAL_DIGITS;
+  }
+  args__decimal_trim(a);
+}
+
+// Divide by 2^k, k <= 60.
+static void args__decimal_rshift(args__decimal_t *a, unsigned k) {
+  int r = 0, w = 0;
+  uint64_t n = 0;
+  // Read enough leading digits to produce the first output digit
+  for (; n >> k == 0; r++) {
+    if (r >= a->nd) {
+      if (n == 0) {
+        a->nd = 0;
+        return;
       }
+      while (n >> k == 0) n *= 10, r++;
+      break;
     }
-    flag = strtok(NULL, "|");
+    n = n * 10 + a->d[r];
   }
-  return result;
+  a->dp -= r - 1;
+  uint64_t mask = ((uint64_t)1 << k) - 1;
+  for (; r < a->nd; r++) {
+    a->d[w++] = (uint8_t)(n >> k);
+    n = (n & mask) * 10 + a->d[r];
+  }
+  while (n > 0) {
+    uint8_t digit = (uint8_t)(n >> k);
+    n = (n & mask) * 10;
+    if (w < ARGS__DECIMAL_DIGITS) a->d[w++] = digit;
+    else if (digit) a->trunc = true;
+  }
+  a->nd = w;
+  args__decimal_trim(a);
+}
+
+// Multiply by 2^k, k may be negative.
+static void args__decimal_shift(args__decimal_t *a, int k) {
+  if (a->nd == 0) return;
+  for (; k > 60; k -= 60) args__decimal_lshift(a, 60);
+  if (k > 0) args__decimal_lshift(a, k);
+  for (; k < -60; k += 60) args__decimal_rshift(a, 60);
+  if (k < 0) args__decimal_rshift(a, -k);
+}
+
+// Integer part of the decimal, rounded half to even.
+static uint64_t args__decimal_round(const args__decimal_t *a) {
+  if (a->dp > 20) return UINT64_MAX;
+  uint64_t n = 0;
+  int i = 0;
+  for (; i < a->dp && i < a->nd; ++i) n = n * 10 + a->d[i];
+  for (; i < a->dp; ++i) n *= 10;
+  if (a->dp >= 0 && a->dp < a->nd) {
+    bool up = a->d[a->dp] > 5;
+    if (a->d[a->dp] == 5) up = a->trunc || a->dp + 1 < a->nd || (a->dp > 0 && a->d[a->dp - 1] % 2);
+    n += up;
+  }
+  return n;
+}
+
+// Convert decimal to IEEE 754 double bits without sign, by scaling it into [1/2, 1) with binary shifts.
+// Returns false on overflow.
+static bool args__decimal_to_bits(args__decimal_t *a, uint64_t *bits) {
+  static const int powtab[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+  const int npowtab = sizeof(powtab) / sizeof(powtab[0]);
+  const int bias = -1023;
+  int exp = 0;
+  uint64_t mant;
+  if (a->nd == 0 || a->dp < -330) {
+    *bits = 0;
+    return true;
+  }
+  if (a->dp > 310) return false;
+  while (a->dp > 0) {
+    int n = a->dp >= npowtab ? 27 : powtab[a->dp];
+    args__decimal_shift(a, -n);
+    exp += n;
+  }
+  while (a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+    int n = -a->dp >= npowtab ? 27 : powtab[-a->dp];
+    args__decimal_shift(a, n);
+    exp -= n;
+  }
+  // Now value is in [1/2, 1), move to [1, 2)
+  exp--;
+  // Denormal
+  if (exp < bias + 1) {
+    int n = bias + 1 - exp;
+    args__decimal_shift(a, -n);
+    exp += n;
+  }
+  if (exp - bias >= 0x7FF) return false;
+  args__decimal_shift(a, 53);
+  mant = args__decimal_round(a);
+  // Rounding carried into the next power of two
+  if (mant == (uint64_t)2 << 52) {
+    mant >>= 1;
+    exp++;
+    if (exp - bias >= 0x7FF) return false;
+  }
+  if (!(mant & ((uint64_t)1 << 52))) exp = bias;
+  *bits = (mant & (((uint64_t)1 << 52) - 1)) | ((uint64_t)((exp - bias) & 0x7FF) << 52);
+  return true;
+}
+
+static double args__bits_to_double(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+// Locale independent `strtod()` replacement that requires the whole slice to be a number.
+// Uses exact double arithmetic when mantissa and power of ten fit into a double (Clinger's fast path),
+// and falls back to arbitrary precision decimal otherwise, so result is always correctly rounded.
+static args_err_t args__parse_double(const char *s, size_t len, double *out) {
+  static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const uint64_t sign = (uint64_t)1 << 63;
+  size_t i = 0;
+  bool negative = false;
+  if (i < len && (s[i] == '-' || s[i] == '+')) negative = s[i++] == '-';
+  if (args__equal_nocase(s + i, len - i, "inf") || args__equal_nocase(s + i, len - i, "infinity")) {
+    *out = args__bits_to_double(0x7FF0000000000000ull | (negative ? sign : 0));
+    return ARGS_OK;
+  }
+  if (args__equal_nocase(s + i, len - i, "nan")) {
+    *out = args__bits_to_double(0x7FF8000000000000ull | (negative ? sign : 0));
+    return ARGS_OK;
+  }
+  // Mantissa
+  args__decimal_t dec;
+  dec.nd = 0;
+  dec.dp = 0;
+  dec.trunc = false;
+  uint64_t mant = 0;
+  int ndigits = 0;
+  bool has_digits = false, has_dot = false;
+  for (; i < len; ++i) {
+    if (s[i] == '.') {
+      if (has_dot) break;
+      has_dot = true;
+      continue;
+    }
+    unsigned digit = (unsigned char)s[i] - '0';
+    if (digit > 9) break;
+    has_digits = true;
+    // Skip leading zeros
+    if (digit == 0 && ndigits == 0) {
+      if (has_dot) dec.dp--;
+      continue;
+    }
+    if (ndigits < 19) mant = mant * 10 + digit;
+    if (dec.nd < ARGS__DECIMAL_DIGITS) dec.d[dec.nd++] = digit;
+    else if (digit) dec.trunc = true;
+    ndigits++;
+    if (!has_dot) dec.dp++;
+  }
+  if (!has_digits) return ARGS_ERR_INVALID;
+  // Exponent
+  if (i < len && (s[i] | 0x20) == 'e') {
+    bool exp_negative = false;
+    int exp = 0;
+    if (++i < len && (s[i] == '-' || s[i] == '+')) exp_negative = s[i++] == '-';
+    if (i == len) return ARGS_ERR_INVALID;
+    for (; i < len; ++i) {
+      unsigned digit = (unsigned char)s[i] - '0';
+      if (digit > 9) return ARGS_ERR_INVALID;
+      if (exp < 100000) exp = exp * 10 + digit;
+    }
+    dec.dp += exp_negative ? -exp : exp;
+  }
+  if (i != len) return ARGS_ERR_INVALID;
+  double result;
+  int exp10 = dec.dp - ndigits;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  if (ndigits <= 19 && mant <= (uint64_t)1 << 53 && exp10 >= -22 && exp10 <= 22) {
+    result = (double)mant;
+    result = exp10 < 0 ? result / pow10[-exp10] : result * pow10[exp10];
+    *out = negative ? -result : result;
+    return ARGS_OK;
+  }
+#else
+  (void)mant, (void)exp10, (void)pow10;
+#endif
+  args__decimal_trim(&dec);
+  uint64_t bits;
+  if (!args__decimal_to_bits(&dec, &bits)) return ARGS_ERR_RANGE;
+  result = args__bits_to_double(bits);
+  *out = negative ? -result : result;
+  return ARGS_OK;
+}
+
+// Length of the decimal number with optional fraction at the start of `s`.
+static size_t args__decimal_len(const char *s, size_t len) {
+  size_t n = 0;
+  while (n < len && ((s[n] >= '0' && s[n] <= '9') || s[n] == '.')) n++;
+  return n;
+}
+
+// Parse decimal number `s`, optionally with a fraction, multiplied by `unit` and rounded to nearest.
+static args_err_t args__parse_scaled(const char *s, size_t len, uint64_t unit, uint64_t *out) {
+  if (!memchr(s, '.', len)) {
+    uint64_t value;
+    args_err_t err = args__parse_u64(s, len, &value);
+    if (err) return err;
+    if (value > UINT64_MAX / unit) return ARGS_ERR_RANGE;
+    *out = value * unit;
+    return ARGS_OK;
+  }
+  double value;
+  args_err_t err = args__parse_double(s, len, &value);
+  if (err) return err;
+  value = value * (double)unit + 0.5;
+  // 2^64
+  if (value >= 18446744073709551616.0) return ARGS_ERR_RANGE;
+  *out = (uint64_t)value;
+  return ARGS_OK;
+}
+
+static args_err_t args__parse_bytes(const char *s, size_t len, uint64_t *out) {
+  static const char prefixes[] = "kmgtpe";
+  size_t n = args__decimal_len(s, len);
+  const char *suffix = s + n;
+  size_t rest = len - n;
+  uint64_t unit = 1;
+  if (rest) {
+    char c = suffix[0] >= 'A' && suffix[0] <= 'Z' ? (char)(suffix[0] | 0x20) : suffix[0];
+    const char *prefix = c ? (const char *)memchr(prefixes, c, sizeof(prefixes) - 1) : NULL;
+    // Lone `e` reads like an exponent, `1e` is a typo rather than 2^60 bytes
+    if (rest == 1 && suffix[0] == 'e') return ARGS_ERR_INVALID;
+    if (prefix) {
+      // `K` and `KiB` are binary, `KB` is decimal
+      bool decimal = args__equal_nocase(suffix + 1, rest - 1, "b");
+      if (!decimal && rest > 1 && !args__equal_nocase(suffix + 1, rest - 1, "ib")) return ARGS_ERR_INVALID;
+      for (const char *p = prefixes; p <= prefix; ++p) unit *= decimal ? 1000 : 1024;
+    } else if (!args__equal_nocase(suffix, rest, "b")) return ARGS_ERR_INVALID;
+  }
+  return args__parse_scaled(s, n, unit, out);
+}
+
+static args_err_t args__parse_duration(const char *s, size_t len, uint64_t *out) {
+  static const struct {
+    const char *name;
+    uint64_t ns;
+  } units[] = {{"ns", 1},
+               {"us", 1000},
+               {"\xC2\xB5s", 1000},
+               {"ms", 1000000},
+               {"s", 1000000000},
+               {"m", 60000000000ull},
+               {"h", 3600000000000ull},
+               {"d", 86400000000000ull}};
+  if (!len) return ARGS_ERR_INVALID;
+  uint64_t total = 0;
+  for (size_t i = 0; i < len;) {
+    size_t n = args__decimal_len(s + i, len - i), end = i + n;
+    while (end < len && !args__decimal_len(s + end, 1)) end++;
+    // Plain number is seconds
+    uint64_t unit = i == 0 && end == len && n == len ? 1000000000 : 0;
+    for (size_t u = 0; u < sizeof(units) / sizeof(units[0]) && !unit; ++u)
+      if (strlen(units[u].name) == end - i - n && !memcmp(units[u].name, s + i + n, end - i - n)) unit = units[u].ns;
+    if (!unit) return ARGS_ERR_INVALID;
+    uint64_t part;
+    args_err_t err = args__parse_scaled(s + i, n, unit, &part);
+    if (err) return err;
+    if (part > UINT64_MAX - total) return ARGS_ERR_RANGE;
+    total += part;
+    i = end;
+  }
+  *out = total;
+  return ARGS_OK;
+}
+
+static size_t args__align(size_t size) { return (size + ARGS__ALIGN - 1) & ~(size_t)(ARGS__ALIGN - 1); }
+
+// Allocate memory owned by `ctx`, from the arena if there is one, otherwise from the heap.
+// Safe to call from many threads at once.
+static void *args__alloc(args_ctx_t *ctx, size_t size) {
+  size = args__align(size);
+  if (ctx->arena) {
+    size_t used = ARGS__LOAD(&ctx->arena_used);
+    do {
+      if (size > ctx->arena_cap - used) return NULL;
+    } while (!ARGS__CAS(&ctx->arena_used, &used, used + size));
+    return ctx->arena + used;
+  }
+  args__block_t *block = (args__block_t *)ARGS_MALLOC(ARGS__ALIGN + size);
+  if (!block) return NULL;
+  block->next = ARGS__LOAD(&ctx->heap);
+  while (!ARGS__CAS(&ctx->heap, &block->next, block));
+  return (unsigned char *)block + ARGS__ALIGN;
+}
+
+// Map file into writable private memory, followed by at least one zero byte, so tokens can be terminated in place.
+// Returns false if file can't be mapped or there is no room for another file.
+// Scanning reads whole aligned blocks, which may extend past the end of a string,
+// but never past the page that holds its last byte.
+#if defined(__SANITIZE_ADDRESS__)
+#define ARGS__NO_SANITIZE __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ARGS__NO_SANITIZE __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef ARGS__NO_SANITIZE
+#define ARGS__NO_SANITIZE
+#endif
+
+// Masks of interesting bytes in one aligned block, byte `i` is bit `i << ARGS__SCAN_SHIFT`.
+typedef struct {
+  uint64_t nul;
+  uint64_t eq;
+  uint64_t quote;
+  uint64_t space;
+} args__masks_t;
+
+#if defined(ARGS__AVX2)
+#define ARGS__SCAN_WIDTH 32
+#define ARGS__SCAN_SHIFT 0
+
+static uint64_t args__match(__m256i v, char c) {
+  return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+}
+
+ARGS__NO_SANITIZE static void args__classify(const char *p, args__masks_t *m) {
+  __m256i v = _mm256_load_si256((const __m256i *)p);
+#elif defined(ARGS__SSE2)
+#define ARGS__SCAN_WIDTH 16
+#define ARGS__SCAN_SHIFT 0
+
+static uint64_t args__match(__m128i v, char c) {
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+}
+
+ARGS__NO_SANITIZE static void args__classify(const char *p, args__masks_t *m) {
+  __m128i v = _mm_load_si128((const __m128i *)p);
+#elif defined(ARGS__NEON)
+#define ARGS__SCAN_WIDTH 16
+#define ARGS__SCAN_SHIFT 2
+
+// There is no movemask, narrow every byte of the comparison to a nibble and keep one bit of it
+static uint64_t args__match(uint8x16_t v, char c) {
+  uint8x16_t eq = vceqq_u8(v, vdupq_n_u8((uint8_t)c));
+  uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x1111111111111111ull;
+}
+
+ARGS__NO_SANITIZE static void args__classify(const char *p, args__masks_t *m) {
+  uint8x16_t v = vld1q_u8((const uint8_t *)p);
+#else
+#define ARGS__SCAN_WIDTH 8
+#define ARGS__SCAN_SHIFT 3
+
+// High bit is set in every byte equal to `c`, exactly, unlike the cheaper test in `args__find_byte()`
+static uint64_t args__match(uint64_t v, char c) {
+  const uint64_t lows = 0x7F7F7F7F7F7F7F7Full;
+  v ^= 0x0101010101010101ull * (unsigned char)c;
+  return ~(((v & lows) + lows) | v | lows);
+}
+
+ARGS__NO_SANITIZE static void args__classify(const char *p, args__masks_t *m) {
+  uint64_t v;
+  memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+#endif
+  m->nul = args__match(v, '\0');
+  m->eq = args__match(v, '=');
+  m->quote = args__match(v, '"');
+  m->space = args__match(v, ' ') | args__match(v, '\t') | args__match(v, '\n') | args__match(v, '\r');
+}
+
+// Offsets of interesting bytes in a NUL-terminated token, missing ones are equal to `len`.
+typedef struct {
+  size_t len;      // Length of the token
+  size_t eq;       // First `=`
+  size_t quote[2]; // First two `"` after the `=`
+} args__scan_t;
+
+// Classify token in one pass over aligned blocks.
+static void args__scan(const char *s, args__scan_t *out) {
+  const size_t none = (size_t)-1;
+  out->eq = out->quote[0] = out->quote[1] = none;
+  size_t offset = (uintptr_t)s % ARGS__SCAN_WIDTH, nquotes = 0;
+  const char *block = s - offset;
+  // Ignore bytes before the start of the token
+  uint64_t skip = ~(uint64_t)0 << (offset << ARGS__SCAN_SHIFT);
+  for (;; block += ARGS__SCAN_WIDTH, skip = ~(uint64_t)0) {
+    args__masks_t m;
+    args__classify(block, &m);
+    ptrdiff_t base = block - s;
+    uint64_t nul = m.nul & skip;
+    // Ignore bytes after the terminator
+    uint64_t live = (nul ? (nul & (0 - nul)) - 1 : ~(uint64_t)0) & skip;
+    uint64_t eq = m.eq & live, quote = m.quote & live;
+    if (out->eq == none && eq) {
+      out->eq = base + (__builtin_ctzll(eq) >> ARGS__SCAN_SHIFT);
+      uint64_t first = eq & (0 - eq);
+      quote &= ~(first | (first - 1));
+    }
+    if (out->eq != none)
+      for (; quote && nquotes < 2; quote &= quote - 1)
+        out->quote[nquotes++] = base + (__builtin_ctzll(quote) >> ARGS__SCAN_SHIFT);
+    if (nul) {
+      out->len = base + (__builtin_ctzll(nul) >> ARGS__SCAN_SHIFT);
+      break;
+    }
+  }
+  if (out->eq == none) out->eq = out->len;
+  if (out->quote[0] == none) out->quote[0] = out->len;
+  if (out->quote[1] == none) out->quote[1] = out->len;
+}
+
+// Find first `c` in [p, end) eight bytes at a time, or return `end`.
+static const char *args__find_byte(const char *p, const char *end, char c) {
+  const uint64_t ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+  const uint64_t pattern = ones * (unsigned char)c;
+  for (; end - p >= 8; p += 8) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    v ^= pattern;
+    // High bit is set in every byte of `v` that was equal to `c`
+    uint64_t found = (v - ones) & ~v & highs;
+    if (found) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      return p + (__builtin_clzll(found) >> 3);
+#else
+      return p + (__builtin_ctzll(found) >> 3);
+#endif
+    }
+  }
+  for (; p < end; ++p)
+    if (*p == c) return p;
+  return end;
+}
+
+// Find first `"` in [p, end), or whitespace (including NUL) too if `spaces` is set. Returns `end` if there is none.
+// Bytes up to the end of the last block must be readable, response file mappings are padded for that.
+static char *args__scan_file(char *p, char *end, bool spaces) {
+  size_t offset = (uintptr_t)p % ARGS__SCAN_WIDTH;
+  char *block = p - offset;
+  uint64_t skip = ~(uint64_t)0 << (offset << ARGS__SCAN_SHIFT);
+  for (; block < end; block += ARGS__SCAN_WIDTH, skip = ~(uint64_t)0) {
+    args__masks_t m;
+    args__classify(block, &m);
+    uint64_t found = (spaces ? m.quote | m.space | m.nul : m.quote) & skip;
+    if (found) {
+      char *at = block + (__builtin_ctzll(found) >> ARGS__SCAN_SHIFT);
+      return at < end ? at : end;
+    }
+  }
+  return end;
+}
+
+#ifdef ARGS_NO_RESPONSE_FILES
+#define ARGS__RESPONSE_FILES 0
+#else
+#define ARGS__RESPONSE_FILES 1
+#endif
+
+// Map file `path` into `ctx->files`, followed by at least one zero byte. `arg` is the response file argument or -1.
+static bool args__map_file(args_ctx_t *ctx, const char *path, int arg) {
+#ifdef ARGS__MMAP
+  if (ctx->nfiles == ARGS_MAX_FILES) return false;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t map_size = (size + page) / page * page;
+  // Reserve zeroed pages first, then put the file on top of them
+#ifdef ARGS__MAP_ANON
+  char *data = (char *)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | ARGS__MAP_ANON, -1, 0);
+#else
+  // Strict C modes hide anonymous mappings, private pages of `/dev/zero` are the same
+  char *data = (char *)MAP_FAILED;
+  int zero = open("/dev/zero", O_RDWR);
+  if (zero >= 0) {
+    data = (char *)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, zero, 0);
+    close(zero);
+  }
+#endif
+  if (data == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  if (size && mmap(data, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+    munmap(data, map_size);
+    close(fd);
+    return false;
+  }
+  close(fd);
+  ctx->files[ctx->nfiles].data = data;
+  ctx->files[ctx->nfiles].size = size;
+  ctx->files[ctx->nfiles].map_size = map_size;
+  ctx->files[ctx->nfiles].arg = arg;
+  ctx->nfiles++;
+  return true;
+#else
+  (void)ctx, (void)path, (void)arg;
+  return false;
+#endif
+}
+
+static void args__unmap_files(args_ctx_t *ctx) {
+#ifdef ARGS__MMAP
+  for (int i = 0; i < ctx->nfiles; ++i) munmap(ctx->files[i].data, ctx->files[i].map_size);
+#endif
+  ctx->nfiles = 0;
+}
+
+static bool args__is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0'; }
+
+static bool args__is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+// Keys of decoded short flags, `-x` is at `2 * index of x`.
+static const char args__short_keys[] = "-a-b-c-d-e-f-g-h-i-j-k-l-m-n-o-p-q-r-s-t-u-v-w-x-y-z"
+                                       "-A-B-C-D-E-F-G-H-I-J-K-L-M-N-O-P-Q-R-S-T-U-V-W-X-Y-Z";
+
+static const char *args__short_key(char c) { return args__short_keys + 2 * (c >= 'a' ? c - 'a' : c - 'A' + 26); }
+
+// Number of short flags in cluster `-abc` or `-p8080`, 0 if `s` is not one of `options`.
+// Every letter must be in `options`, the rest after a value-taking letter is its attached value.
+static size_t args__short_flags(const char *s, size_t len, const char *options) {
+  if (!options || len < 3 || s[0] != '-' || memchr(s, '=', len)) return 0;
+  size_t n = 0;
+  while (n + 1 < len) {
+    const char *opt = args__is_alpha(s[n + 1]) ? strchr(options, s[n + 1]) : NULL;
+    if (!opt) return 0;
+    n++;
+    if (opt[1] == ':') break;
+  }
+  return n;
+}
+
+// Split response file into whitespace separated tokens, respecting double quotes.
+// If `out` is NULL only counts tokens and adds their short flags of `options` to `nshort`,
+// otherwise terminates them in place and stores them as keys of `out`.
+static size_t args__split_file(char *data, size_t size, args__token_t *out, size_t *nshort, const char *options) {
+  size_t n = 0;
+  char *p = data, *end = data + size;
+  while (p < end) {
+    while (p < end && args__is_space(*p)) p++;
+    if (p == end) break;
+    char *start = p;
+    // Skip to the next whitespace outside of quotes
+    for (bool quoted = false; (p = args__scan_file(p, end, !quoted)) < end && *p == '"'; ++p) quoted = !quoted;
+    char *stop = p;
+    // Argument is `"multi word value"`. Both passes look at it without quotes, so their short flags agree.
+    if (stop - start >= 2 && *start == '"' && stop[-1] == '"') start++, stop--;
+    if (out) {
+      *stop = '\0';
+      out[n].key = start;
+    } else *nshort += args__short_flags(start, (size_t)(stop - start), options);
+    n++;
+  }
+  return n;
+}
+
+// Insert `tokens[i]` into the index, or replace its key, so that the slot always points to the last occurrence.
+static void args__index_token(args__token_t *tokens, args__slot_t *slots, size_t mask, uint32_t seed, size_t i) {
+  args__token_t *tok = &tokens[i];
+  uint32_t hash = args__hash(tok->key, tok->key_len);
+  size_t j = args__slot_start(tok->key, tok->key_len, hash, seed) & mask;
+  while (slots[j].token >= 0) {
+    const args__token_t *other = &tokens[slots[j].token];
+    if (slots[j].hash == hash && other->key_len == tok->key_len && !memcmp(other->key, tok->key, tok->key_len)) break;
+    j = (j + 1) & mask;
+  }
+  tok->prev = slots[j].token;
+  tok->hash = hash;
+  tok->flag = -1;
+  slots[j].hash = hash;
+  slots[j].token = (int)i;
+}
+
+// Length of `s`, or `max + 1` if it is longer than `max`.
+static size_t args__bounded_len(const char *s, size_t max) {
+  const char *end = (const char *)memchr(s, '\0', max + 1);
+  return end ? (size_t)(end - s) : max + 1;
+}
+
+// Parse into `ctx` within limits of `opts`, which can be NULL. Sets `*err` to `ARGS_ERR_RANGE` if one is exceeded.
+static size_t args__init(args_ctx_t *ctx, int argc, char **argv, void *buf, size_t cap, const args_parse_opts_t *opts,
+                         args_err_t *err) {
+  memset(ctx, 0, sizeof(*ctx));
+  *err = ARGS_OK;
+  size_t max_tokens = opts && opts->max_tokens ? opts->max_tokens : SIZE_MAX;
+  size_t max_len = opts && opts->max_token_len ? opts->max_token_len : SIZE_MAX;
+  const char *options = opts ? opts->short_options : NULL;
+  // Count tokens, expanding response files, and short flags decoded from them.
+  // Stop at the first argument over a limit, before looking at the rest.
+  bool over = argc > 1 && (size_t)(argc - 1) > max_tokens;
+  size_t nargs = 0, nshort = 0;
+  for (int i = 1; i < argc && !over; ++i) {
+    if (ARGS__RESPONSE_FILES && argv[i][0] == '@' && args__map_file(ctx, argv[i] + 1, i))
+      nargs += args__split_file(ctx->files[ctx->nfiles - 1].data, ctx->files[ctx->nfiles - 1].size, NULL, &nshort,
+                                options);
+    else {
+      size_t len = max_len == SIZE_MAX ? strlen(argv[i]) : args__bounded_len(argv[i], max_len);
+      over = len > max_len;
+      nshort += args__short_flags(argv[i], len, options);
+      nargs++;
+    }
+    over = over || nargs > max_tokens;
+  }
+  if (over) {
+    args__unmap_files(ctx);
+    *err = ARGS_ERR_RANGE;
+    return 0;
+  }
+  size_t ntokens = nargs + nshort;
+  // Keep the table at most half full
+  size_t nslots = 8;
+  while (nslots < ntokens * 2) nslots <<= 1;
+  size_t words = ARGS__BITMAPS * ((ntokens + 63) / 64);
+  size_t mem_size = args__align(ntokens * sizeof(args__token_t)) + args__align(nslots * sizeof(args__slot_t)) +
+                    args__align(words * sizeof(uint64_t));
+  // Arena also has room for the arrays of `args_ctx_unknown()` and `args_ctx_positional()`
+  size_t size = ntokens ? mem_size + 2 * args__align(nargs * sizeof(const char *)) : 0;
+  if (buf) {
+    size_t pad = (ARGS__ALIGN - (uintptr_t)buf % ARGS__ALIGN) % ARGS__ALIGN;
+    size += pad;
+    if (size > cap) {
+      args__unmap_files(ctx);
+      return size;
+    }
+    ctx->arena = (unsigned char *)buf + pad;
+    ctx->arena_cap = cap - pad;
+  }
+  ctx->argc = argc;
+  ctx->argv = argv;
+  ctx->seed = opts ? opts->seed : 0;
+  ctx->threads = opts ? opts->threads : 0;
+  if (!ntokens) return size;
+  // Tokens, slots and consumed bitmap share one allocation
+  unsigned char *mem = (unsigned char *)args__alloc(ctx, mem_size);
+  if (!mem) {
+    args__unmap_files(ctx);
+    return size;
+  }
+  ctx->tokens = (args__token_t *)mem;
+  ctx->slots = (args__slot_t *)(mem + args__align(ntokens * sizeof(args__token_t)));
+  ctx->slots_mask = nslots - 1;
+  ctx->consumed = (uint64_t *)(mem + args__align(ntokens * sizeof(args__token_t)) +
+                               args__align(nslots * sizeof(args__slot_t)));
+  memset(ctx->consumed, 0, words * sizeof(uint64_t));
+  ctx->ntokens = ntokens;
+  for (size_t i = 0; i < nslots; ++i) ctx->slots[i].token = -1;
+  // Collect token strings
+  size_t n = 0;
+  for (int i = 1, file = 0; i < argc; ++i) {
+    if (file < ctx->nfiles && ctx->files[file].arg == i) {
+      n += args__split_file(ctx->files[file].data, ctx->files[file].size, ctx->tokens + n, NULL, NULL);
+      file++;
+    } else ctx->tokens[n++].key = argv[i];
+  }
+  // Split keys and values using precomputed offsets
+  for (size_t i = 0; i < nargs; ++i) {
+    args__token_t *tok = &ctx->tokens[i];
+    args__scan_t scan;
+    args__scan(tok->key, &scan);
+    // Arguments of response files are measured only here
+    if (scan.len > max_len) {
+      args_ctx_free(ctx);
+      *err = ARGS_ERR_RANGE;
+      return 0;
+    }
+    tok->key_len = scan.eq;
+    tok->len = scan.len;
+    tok->has_eq = scan.eq < scan.len;
+    tok->value = tok->has_eq ? tok->key + scan.eq + 1 : NULL;
+    tok->value_len = tok->has_eq ? scan.len - scan.eq - 1 : 0;
+    tok->string = (args_string_view_t){tok->value, tok->value_len};
+    // Value is `--flag="multi word value"`, closing quote is optional. `quote[0]` is `len` if there is no quote.
+    if (tok->has_eq && scan.quote[0] == scan.eq + 1 && scan.quote[0] < scan.len)
+      tok->string = (args_string_view_t){tok->value + 1, scan.quote[1] - scan.quote[0] - 1};
+    tok->source = -1;
+  }
+  // Decode `-abc` into `-a`, `-b`, `-c` and `-p8080` into `-p` with value `8080`, if they are in `options`.
+  // Short flags follow their cluster, so tokens stay in command line order. Cluster itself is kept as is.
+  for (size_t i = nargs, pos = ntokens; i-- > 0;) {
+    args__token_t cluster = ctx->tokens[i];
+    size_t count = cluster.has_eq ? 0 : args__short_flags(cluster.key, cluster.len, options);
+    pos -= count + 1;
+    ctx->tokens[pos] = cluster;
+    for (size_t j = 0; j < count; ++j) {
+      args__token_t *tok = &ctx->tokens[pos + 1 + j];
+      size_t at = j + 2;
+      tok->key = args__short_key(cluster.key[at - 1]);
+      tok->key_len = tok->len = 2;
+      tok->has_eq = j + 1 == count && at < cluster.len;
+      tok->value = tok->has_eq ? cluster.key + at : NULL;
+      tok->value_len = tok->has_eq ? cluster.len - at : 0;
+      tok->string = (args_string_view_t){tok->value, tok->value_len};
+      tok->source = (int)pos;
+    }
+  }
+  // Arg is `--flag <value>`, value is the next argument. Only the last flag of a cluster can take it.
+  for (size_t i = ntokens, next = ntokens; i-- > 0;) {
+    args__token_t *tok = &ctx->tokens[i];
+    bool last = i + 1 == ntokens || ctx->tokens[i + 1].source < 0 || ctx->tokens[i + 1].source != tok->source;
+    tok->value_token = -1;
+    if (!tok->has_eq && last && next < ntokens) {
+      tok->value = ctx->tokens[next].key;
+      tok->value_len = ctx->tokens[next].len;
+      tok->string = (args_string_view_t){tok->value, tok->value_len};
+      tok->value_token = (int)next;
+    }
+    if (tok->source < 0) next = i;
+  }
+  for (size_t i = 0; i < ntokens; ++i) args__index_token(ctx->tokens, ctx->slots, ctx->slots_mask, ctx->seed, i);
+  return size;
+}
+
+void args_ctx_init(args_ctx_t *ctx, int argc, char **argv) {
+  args_err_t err;
+  args__init(ctx, argc, argv, NULL, 0, NULL, &err);
+}
+
+args_err_t args_ctx_init_opts(args_ctx_t *ctx, int argc, char **argv, const args_parse_opts_t *opts) {
+  args_err_t err;
+  args__init(ctx, argc, argv, NULL, 0, opts, &err);
+  return err;
+}
+
+// Collect tokens that are not consumed, flags if `flags` is set, positional arguments otherwise.
+static const char *const *args__leftover(const args_ctx_t *ctx, bool flags, size_t *count) {
+  *count = 0;
+  // Two passes, so that the array is exact
+  const char **result = NULL;
+  for (int pass = 0; pass < 2; ++pass) {
+    size_t n = 0;
+    bool positional_only = false;
+    for (size_t i = 0; i < ctx->ntokens; ++i) {
+      if (ctx->tokens[i].source >= 0) continue;
+      const char *key = ctx->tokens[i].key;
+      bool consumed = args__marked(ctx, i);
+      // Cluster `-abc` is consumed when all of its short flags are
+      size_t j = i + 1;
+      while (!consumed && j < ctx->ntokens && ctx->tokens[j].source == (int)i && args__marked(ctx, j)) j++;
+      if (j > i + 1 && (j == ctx->ntokens || ctx->tokens[j].source != (int)i)) consumed = true;
+      if (!positional_only && !consumed && !strcmp(key, "--")) {
+        positional_only = true;
+        continue;
+      }
+      bool flag = !positional_only && key[0] == '-' && key[1];
+      if (flag != flags || (consumed && !positional_only)) continue;
+      if (result) result[n] = key;
+      n++;
+    }
+    if (pass || !n) {
+      *count = n;
+      break;
+    }
+    result = (const char **)args__alloc((args_ctx_t *)ctx, n * sizeof(const char *));
+    if (!result) {
+      *count = n;
+      return NULL;
+    }
+  }
+  return result;
+}
+
+const char *const *args_ctx_unknown(const args_ctx_t *ctx, size_t *count) { return args__leftover(ctx, true, count); }
+
+const char *const *args_ctx_positional(const args_ctx_t *ctx, size_t *count) {
+  return args__leftover(ctx, false, count);
+}
+
+int args_ctx_subcommand(args_ctx_t *ctx, int argc, char **argv, const char *const *commands, size_t ncommands) {
+  int found = -1;
+  if (argc > 1) {
+    // Dispatch happens once per process, so building a table would cost more than one scan of the variants
+    const char *name = argv[1];
+    size_t name_len = strlen(name);
+    for (size_t i = 0; i < ncommands && found < 0; ++i) {
+      const char *spec = commands[i], *variant;
+      size_t len;
+      while ((variant = args__next_alias(&spec, &len)))
+        if (len == name_len && !memcmp(variant, name, len)) {
+          found = (int)i;
+          break;
+        }
+    }
+  }
+  // Subcommand takes place of the program name
+  if (found >= 0) args_ctx_init(ctx, argc - 1, argv + 1);
+  else args_ctx_init(ctx, argc, argv);
+  return found;
+}
+
+// Allocate layer of `ntokens` tokens with an empty index, followed by `extra` bytes for its text at `*text`.
+static args__layer_t *args__new_layer(args_ctx_t *ctx, size_t ntokens, size_t extra, char **text) {
+  size_t nslots = 8;
+  while (nslots < ntokens * 2) nslots <<= 1;
+  size_t tokens_size = args__align(ntokens * sizeof(args__token_t));
+  size_t slots_size = args__align(nslots * sizeof(args__slot_t));
+  unsigned char *mem =
+      (unsigned char *)args__alloc(ctx, args__align(sizeof(args__layer_t)) + tokens_size + slots_size + extra);
+  if (!mem) return NULL;
+  if (text) *text = (char *)mem + args__align(sizeof(args__layer_t)) + tokens_size + slots_size;
+  args__layer_t *layer = (args__layer_t *)mem;
+  layer->next = NULL;
+  layer->tokens = (args__token_t *)(mem + args__align(sizeof(args__layer_t)));
+  layer->ntokens = ntokens;
+  layer->slots = (args__slot_t *)(mem + args__align(sizeof(args__layer_t)) + tokens_size);
+  layer->slots_mask = nslots - 1;
+  layer->values = NULL;
+  for (size_t i = 0; i < nslots; ++i) layer->slots[i].token = -1;
+  return layer;
+}
+
+// Fill layer token with `key=value`, or just `key` if `value` is NULL.
+// Key is folded in place and leading dashes are skipped.
+static void args__layer_token(args__token_t *tok, char *key, size_t key_len, const char *value, size_t value_len) {
+  for (size_t i = 0; i < key_len; ++i) key[i] = args__fold(key[i]);
+  while (key_len && *key == '-') key++, key_len--;
+  tok->key = key;
+  tok->key_len = key_len;
+  tok->len = value ? (size_t)(value - key) + value_len : key_len;
+  tok->value = value;
+  tok->value_len = value_len;
+  tok->string = (args_string_view_t){value, value_len};
+  tok->has_eq = value != NULL;
+  tok->value_token = -1;
+  tok->source = -1;
+}
+
+// Index `layer` and put it above the other layers.
+static void args__push_layer(args_ctx_t *ctx, args__layer_t *layer) {
+  for (size_t i = 0; i < layer->ntokens; ++i) args__index_token(layer->tokens, layer->slots, layer->slots_mask, 0, i);
+  layer->next = ctx->layers;
+  ctx->layers = layer;
+  // Memoized results could come from a layer with lower priority, the memory is reclaimed with the context
+  ctx->lists = NULL;
+  ctx->cache = NULL;
+}
+
+// Variable `var` starts with `prefix` followed by a non-empty name.
+static bool args__env_match(const char *var, const char *prefix, size_t prefix_len) {
+  return !strncmp(var, prefix, prefix_len) && var[prefix_len] != '=' && strchr(var + prefix_len, '=');
+}
+
+// Split config file into `key=value` lines, or only count them if `out` is NULL.
+// Keys and values are terminated in place.
+static size_t args__split_config(char *data, size_t size, args__token_t *out) {
+  size_t n = 0;
+  for (char *line = data, *end = data + size, *next; line < end; line = next) {
+    char *eol = (char *)args__find_byte(line, end, '\n');
+    next = eol < end ? eol + 1 : end;
+    char *stop = eol;
+    while (line < stop && args__is_space(*line)) line++;
+    while (stop > line && args__is_space(stop[-1])) stop--;
+    if (line == stop || *line == '#') continue;
+    char *eq = (char *)memchr(line, '=', stop - line), *key_end = eq ? eq : stop;
+    while (key_end > line && args__is_space(key_end[-1])) key_end--;
+    if (key_end == line) continue;
+    if (out) {
+      char *value = NULL;
+      if (eq)
+        for (value = eq + 1; value < stop && args__is_space(*value);) value++;
+      size_t value_len = value ? (size_t)(stop - value) : 0;
+      // There is always a byte after the line, mappings end with a zero
+      *stop = '\0';
+      *key_end = '\0';
+      args__token_t *tok = &out[n];
+      args__layer_token(tok, line, key_end - line, value, value_len);
+      // Value is `"multi word value"`, closing quote is optional. Quotes are stripped for typed access too,
+      // so `port = "8080"` reads as a number
+      if (value_len && *value == '"') {
+        const char *quote = (const char *)memchr(value + 1, '"', value_len - 1);
+        tok->string = (args_string_view_t){value + 1, quote ? (size_t)(quote - value - 1) : value_len - 1};
+        tok->value = tok->string.ptr;
+        tok->value_len = tok->string.len;
+      }
+    }
+    n++;
+  }
+  return n;
+}
+
+bool args_ctx_load_file(args_ctx_t *ctx, const char *path) {
+  if (!args__map_file(ctx, path, -1)) return false;
+  char *data = ctx->files[ctx->nfiles - 1].data;
+  size_t size = ctx->files[ctx->nfiles - 1].size;
+  args__layer_t *layer = args__new_layer(ctx, args__split_config(data, size, NULL), 0, NULL);
+  if (!layer) return false;
+  args__split_config(data, size, layer->tokens);
+  args__push_layer(ctx, layer);
+  return true;
+}
+
+// Snapshot layout: header, then for the argv index and every layer, highest priority first,
+// its tokens, slots, converted values and text. Offsets are from the start of the blob.
+#define ARGS__BLOB_MAGIC   0x53475241u // "ARGS" in little endian
+#define ARGS__BLOB_VERSION 1
+#define ARGS__BLOB_NULL    UINT32_MAX
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t size;
+  uint32_t nindexes; // Argv index and layers
+  uint32_t seed;     // Seed of the argv index
+} args__blob_t;
+
+typedef struct {
+  uint64_t ntokens;
+  uint64_t nslots;
+  uint64_t tokens;
+  uint64_t slots;
+  uint64_t values;
+  uint64_t text;
+} args__blob_index_t;
+
+// Token with offsets into the text of its index instead of pointers, or `ARGS__BLOB_NULL`
+typedef struct {
+  uint32_t key, key_len, len;
+  uint32_t value, value_len;
+  uint32_t string, string_len;
+  int32_t prev, value_token, source;
+  uint32_t hash;
+  uint8_t has_eq;
+} args__blob_token_t;
+
+// Offset of `p` in text of `tokens` at `blob`, `p` points into the token `i`, its value or its cluster.
+static uint32_t args__blob_ref(const args__token_t *tokens, const args__blob_token_t *blob, size_t i, const char *p) {
+  if (!p) return ARGS__BLOB_NULL;
+  int candidates[3] = {(int)i, tokens[i].value_token, tokens[i].source};
+  for (size_t c = 0; c < 3; ++c) {
+    const args__token_t *tok = &tokens[candidates[c] < 0 ? i : (size_t)candidates[c]];
+    if (p >= tok->key && p <= tok->key + tok->len) return blob[tok - tokens].key + (uint32_t)(p - tok->key);
+  }
+  return ARGS__BLOB_NULL;
+}
+
+// Write index of `ntokens` tokens to `base + *at`, or only count its size if `base` is NULL.
+static bool args__blob_index(unsigned char *base, size_t *at, args__blob_index_t *index, const args__token_t *tokens,
+                             size_t ntokens, const args__slot_t *slots, size_t nslots) {
+  size_t text = 0;
+  for (size_t i = 0; i < ntokens; ++i) text += tokens[i].len + 1;
+  if (text >= ARGS__BLOB_NULL) return false;
+  index->ntokens = ntokens;
+  index->nslots = nslots;
+  index->tokens = *at;
+  index->slots = index->tokens + args__align(ntokens * sizeof(args__blob_token_t));
+  index->values = index->slots + args__align(nslots * sizeof(args__slot_t));
+  index->text = index->values + args__align(ntokens * sizeof(args__value_t));
+  *at = index->text + args__align(text);
+  if (!base) return true;
+  args__blob_token_t *blob = (args__blob_token_t *)(base + index->tokens);
+  args__value_t *values = (args__value_t *)(base + index->values);
+  char *chars = (char *)(base + index->text);
+  for (size_t i = 0, offset = 0; i < ntokens; ++i) {
+    memcpy(chars + offset, tokens[i].key, tokens[i].len);
+    blob[i].key = (uint32_t)offset;
+    offset += tokens[i].len + 1;
+  }
+  for (size_t i = 0; i < ntokens; ++i) {
+    const args__token_t *tok = &tokens[i];
+    blob[i].key_len = (uint32_t)tok->key_len;
+    blob[i].len = (uint32_t)tok->len;
+    blob[i].value = args__blob_ref(tokens, blob, i, tok->value);
+    blob[i].value_len = (uint32_t)tok->value_len;
+    blob[i].string = args__blob_ref(tokens, blob, i, tok->string.ptr);
+    blob[i].string_len = (uint32_t)tok->string.len;
+    blob[i].prev = tok->prev;
+    blob[i].value_token = tok->value_token;
+    blob[i].source = tok->source;
+    blob[i].hash = tok->hash;
+    blob[i].has_eq = tok->has_eq;
+    // Terminate quoted strings, so that `args_string()` never writes to the snapshot
+    if (blob[i].string != ARGS__BLOB_NULL) chars[blob[i].string + blob[i].string_len] = '\0';
+    const char *value;
+    size_t len;
+    args_err_t err = args__value(tok, &value, &len);
+    values[i].i64_err = (uint8_t)(err ? err : args__parse_i64(value, len, &values[i].i64));
+    values[i].u64_err = (uint8_t)(err ? err : args__parse_unsigned(value, len, &values[i].u64));
+    values[i].f64_err = (uint8_t)(err ? err : args__parse_double(value, len, &values[i].f64));
+  }
+  if (nslots) memcpy(base + index->slots, slots, nslots * sizeof(args__slot_t));
+  return true;
+}
+
+size_t args_ctx_serialize(const args_ctx_t *ctx, void *buf, size_t cap) {
+  // Two passes, the first one only computes offsets
+  size_t nindexes = 1;
+  for (const args__layer_t *layer = ctx->layers; layer; layer = layer->next) nindexes++;
+  size_t size = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    unsigned char *base = pass ? (unsigned char *)buf : NULL;
+    args__blob_index_t index, *indexes = base ? (args__blob_index_t *)(base + args__align(sizeof(args__blob_t))) : NULL;
+    size_t at = args__align(sizeof(args__blob_t)) + args__align(nindexes * sizeof(args__blob_index_t));
+    if (base) memset(base, 0, size);
+    if (!args__blob_index(base, &at, indexes ? &indexes[0] : &index, ctx->tokens, ctx->ntokens, ctx->slots,
+                          ctx->slots ? ctx->slots_mask + 1 : 0))
+      return 0;
+    size_t i = 1;
+    for (const args__layer_t *layer = ctx->layers; layer; layer = layer->next, ++i)
+      if (!args__blob_index(base, &at, indexes ? &indexes[i] : &index, layer->tokens, layer->ntokens, layer->slots,
+                            layer->slots_mask + 1))
+        return 0;
+    size = at;
+    if (!buf || size > cap) return size;
+  }
+  args__blob_t *header = (args__blob_t *)buf;
+  header->magic = ARGS__BLOB_MAGIC;
+  header->version = ARGS__BLOB_VERSION;
+  header->size = size;
+  header->nindexes = (uint32_t)nindexes;
+  header->seed = ctx->seed;
+  return size;
+}
+
+// Check that `index` lies inside the blob of `size` bytes.
+static bool args__blob_valid(const args__blob_index_t *index, size_t size) {
+  if (index->ntokens > size || index->nslots > size || (index->nslots & (index->nslots - 1))) return false;
+  if (index->ntokens && index->ntokens >= index->nslots) return false;
+  return index->tokens <= index->slots && index->slots <= index->values && index->values <= index->text &&
+         index->tokens + index->ntokens * sizeof(args__blob_token_t) <= index->slots &&
+         index->slots + index->nslots * sizeof(args__slot_t) <= index->values &&
+         index->values + index->ntokens * sizeof(args__value_t) <= index->text && index->text <= size &&
+         index->tokens % ARGS__ALIGN == 0 && index->slots % ARGS__ALIGN == 0 && index->values % ARGS__ALIGN == 0;
+}
+
+// Rebuild tokens from the snapshot index, only the pointers are fixed up.
+static bool args__blob_tokens(const unsigned char *base, size_t size, const args__blob_index_t *index,
+                              args__token_t *tokens) {
+  const args__blob_token_t *blob = (const args__blob_token_t *)(base + index->tokens);
+  const char *text = (const char *)(base + index->text);
+  size_t text_size = size - index->text;
+  // Converted values are used in place, their errors are returned as `args_err_t`
+  const args__value_t *values = (const args__value_t *)(base + index->values);
+  for (size_t i = 0; i < index->ntokens; ++i) {
+    const args__blob_token_t *b = &blob[i];
+    if (values[i].i64_err > ARGS_ERR_NOMEM || values[i].u64_err > ARGS_ERR_NOMEM || values[i].f64_err > ARGS_ERR_NOMEM)
+      return false;
+    if ((size_t)b->key + b->len >= text_size || b->key_len > b->len ||
+        (b->value != ARGS__BLOB_NULL && (size_t)b->value + b->value_len >= text_size) ||
+        (b->string != ARGS__BLOB_NULL && (size_t)b->string + b->string_len >= text_size) || b->prev >= (int32_t)i ||
+        b->value_token >= (int32_t)index->ntokens || b->source >= (int32_t)i)
+      return false;
+    args__token_t *tok = &tokens[i];
+    tok->key = text + b->key;
+    tok->key_len = b->key_len;
+    tok->len = b->len;
+    tok->value = b->value == ARGS__BLOB_NULL ? NULL : text + b->value;
+    tok->value_len = b->value_len;
+    tok->string = (args_string_view_t){b->string == ARGS__BLOB_NULL ? NULL : text + b->string, b->string_len};
+    tok->has_eq = b->has_eq;
+    tok->prev = b->prev < 0 ? -1 : b->prev;
+    tok->hash = b->hash;
+    tok->flag = -1;
+    tok->value_token = b->value_token < 0 ? -1 : b->value_token;
+    tok->source = b->source < 0 ? -1 : b->source;
+  }
+  // Probing stops at an empty slot
+  const args__slot_t *slots = (const args__slot_t *)(base + index->slots);
+  bool empty = false;
+  for (size_t i = 0; i < index->nslots; ++i) {
+    if (slots[i].token >= (int)index->ntokens) return false;
+    if (slots[i].token < 0) empty = true;
+  }
+  return empty || !index->nslots;
+}
+
+bool args_ctx_attach(args_ctx_t *ctx, const void *buf, size_t size) {
+  memset(ctx, 0, sizeof(*ctx));
+  const unsigned char *base = (const unsigned char *)buf;
+  const args__blob_t *header = (const args__blob_t *)buf;
+  size_t at = args__align(sizeof(args__blob_t));
+  if ((uintptr_t)buf % ARGS__ALIGN || size < at || header->magic != ARGS__BLOB_MAGIC ||
+      header->version != ARGS__BLOB_VERSION || header->size != size || !header->nindexes ||
+      header->nindexes > (size - at) / sizeof(args__blob_index_t))
+    return false;
+  const args__blob_index_t *indexes = (const args__blob_index_t *)(base + at);
+  for (size_t i = 0; i < header->nindexes; ++i)
+    if (!args__blob_valid(&indexes[i], size)) return false;
+  // Argv index
+  const args__blob_index_t *index = &indexes[0];
+  size_t words = ARGS__BITMAPS * ((index->ntokens + 63) / 64);
+  // Converted values also mark the context as attached
+  ctx->values = (const args__value_t *)(base + index->values);
+  ctx->seed = header->seed;
+  if (index->ntokens) {
+    unsigned char *mem = (unsigned char *)args__alloc(ctx, args__align(index->ntokens * sizeof(args__token_t)) +
+                                                               args__align(words * sizeof(uint64_t)));
+    if (!mem) return false;
+    ctx->tokens = (args__token_t *)mem;
+    ctx->ntokens = index->ntokens;
+    ctx->consumed = (uint64_t *)(mem + args__align(index->ntokens * sizeof(args__token_t)));
+    memset(ctx->consumed, 0, words * sizeof(uint64_t));
+    // Slots are never written after indexing, so they are used in place
+    ctx->slots = (args__slot_t *)(base + index->slots);
+    ctx->slots_mask = index->nslots - 1;
+    if (!args__blob_tokens(base, size, index, ctx->tokens)) {
+      args_ctx_free(ctx);
+      return false;
+    }
+  }
+  // Layers, linked in reverse so that the first one has the highest priority
+  args__layer_t **tail = &ctx->layers;
+  for (size_t i = 1; i < header->nindexes; ++i) {
+    index = &indexes[i];
+    if (!index->nslots) continue;
+    unsigned char *mem = (unsigned char *)args__alloc(ctx, args__align(sizeof(args__layer_t)) +
+                                                               index->ntokens * sizeof(args__token_t));
+    if (!mem) {
+      args_ctx_free(ctx);
+      return false;
+    }
+    args__layer_t *layer = (args__layer_t *)mem;
+    layer->next = NULL;
+    layer->tokens = (args__token_t *)(mem + args__align(sizeof(args__layer_t)));
+    layer->ntokens = index->ntokens;
+    layer->slots = (args__slot_t *)(base + index->slots);
+    layer->slots_mask = index->nslots - 1;
+    layer->values = (const args__value_t *)(base + index->values);
+    if (!args__blob_tokens(base, size, index, layer->tokens)) {
+      args_ctx_free(ctx);
+      return false;
+    }
+    *tail = layer;
+    tail = &layer->next;
+  }
+  return true;
+}
+
+bool args_ctx_parse_env(args_ctx_t *ctx, const char *prefix) {
+#ifndef ARGS__ENVIRON
+  // No environment in freestanding builds
+  (void)ctx, (void)prefix, (void)args__env_match;
+  return false;
+#else
+  if (!prefix) prefix = "";
+  size_t prefix_len = strlen(prefix), n = 0, text_size = 0;
+  char **env = ARGS__ENVIRON;
+  for (size_t i = 0; env && env[i]; ++i)
+    if (args__env_match(env[i], prefix, prefix_len)) n++, text_size += strlen(env[i] + prefix_len) + 1;
+  // Copies share the allocation of the layer, so nothing is left half filled if it fails
+  char *text;
+  args__layer_t *layer = args__new_layer(ctx, n, text_size, &text);
+  if (!layer) return false;
+  n = 0;
+  for (size_t i = 0; env && env[i] && n < layer->ntokens; ++i) {
+    if (!args__env_match(env[i], prefix, prefix_len)) continue;
+    const char *var = env[i] + prefix_len;
+    size_t len = strlen(var);
+    if (len + 1 > text_size) break;
+    char *copy = text;
+    memcpy(copy, var, len + 1);
+    text += len + 1, text_size -= len + 1;
+    size_t key_len = (size_t)(strchr(copy, '=') - copy);
+    args__layer_token(&layer->tokens[n++], copy, key_len, copy + key_len + 1, len - key_len - 1);
+  }
+  // Environment changed between the passes
+  layer->ntokens = n;
+  args__push_layer(ctx, layer);
+  return true;
+#endif // ARGS__ENVIRON
+}
+
+size_t args_ctx_init_arena(args_ctx_t *ctx, int argc, char **argv, void *buf, size_t cap) {
+  args_err_t err;
+  return args__init(ctx, argc, argv, buf, cap, NULL, &err);
+}
+
+void args_ctx_free(args_ctx_t *ctx) {
+  args__unmap_files(ctx);
+  while (ctx->heap) {
+    args__block_t *next = ctx->heap->next;
+    ARGS_FREE(ctx->heap);
+    ctx->heap = next;
+  }
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+static void args__format(const args_ctx_t *ctx, args__out_t *out) {
+  for (int i = 0; i < ctx->argc; ++i) {
+    args__put_str(out, "Argument ");
+    args__put_uint(out, (uint64_t)i, 0);
+    args__put_str(out, ": ");
+    args__put_str(out, ctx->argv[i]);
+    args__put(out, "\n", 1);
+  }
+}
+
+size_t args_ctx_format(const args_ctx_t *ctx, char *buf, size_t cap) {
+  args__out_t out = {buf, cap ? cap - 1 : 0, 0, 0, false};
+  args__format(ctx, &out);
+  if (cap) buf[out.len] = '\0';
+  return out.total;
+}
+
+void args_ctx_print(const args_ctx_t *ctx) {
+  char buf[ARGS_PRINT_BUFFER];
+  args__out_t out = {buf, sizeof(buf), 0, 0, true};
+  args__format(ctx, &out);
+  if (out.len) args__write(buf, out.len);
+}
+
+#ifdef ARGS_CACHE_SIZE
+// Direct-mapped cache entry, guarded by a sequence lock.
+typedef struct {
+  uint32_t seq;      // Odd while the entry is written
+  uint8_t type;      // `args_type_t` of the result
+  uint8_t err;       // `args_err_t` of the result
+  const char *arg;   // Key
+  uint64_t value[2]; // Result bits
+} args__cache_entry_t;
+
+typedef struct args__cache {
+  args__cache_entry_t entries[ARGS_CACHE_SIZE];
+} args__cache_t;
+
+// Entries a key can be stored in, so that a few colliding hot keys don't evict each other
+#define ARGS__CACHE_WAYS 4
+
+static size_t args__cache_index(const char *arg, args_type_t type) {
+  uint32_t h = (uint32_t)((uintptr_t)arg >> 3) * 0x9E3779B9u;
+  return ((h ^ (h >> 16)) + type) % ARGS_CACHE_SIZE;
+}
+
+// Get cached result of `arg`. Returns false if there is none, or the entry is being written.
+static bool args__cache_get(const args_ctx_t *ctx, const char *arg, args_type_t type, args_err_t *err,
+                            uint64_t value[2]) {
+  args__cache_t *cache = ARGS__LOAD(&((args_ctx_t *)ctx)->cache);
+  if (!cache) return false;
+  size_t index = args__cache_index(arg, type);
+  for (size_t way = 0; way < ARGS__CACHE_WAYS; ++way) {
+    args__cache_entry_t *entry = &cache->entries[(index + way) % ARGS_CACHE_SIZE];
+    uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1) continue;
+    const char *key = __atomic_load_n(&entry->arg, __ATOMIC_RELAXED);
+    uint8_t key_type = __atomic_load_n(&entry->type, __ATOMIC_RELAXED);
+    uint8_t key_err = __atomic_load_n(&entry->err, __ATOMIC_RELAXED);
+    uint64_t bits[2] = {__atomic_load_n(&entry->value[0], __ATOMIC_RELAXED),
+                        __atomic_load_n(&entry->value[1], __ATOMIC_RELAXED)};
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&entry->seq, __ATOMIC_RELAXED) != seq || key != arg || key_type != type) continue;
+    ARGS__STATS_ADD(cache_hits, 1);
+    *err = (args_err_t)key_err;
+    value[0] = bits[0];
+    value[1] = bits[1];
+    return true;
+  }
+  return false;
+}
+
+// Store result of `arg` into a free entry, or replace one. Gives up if another thread writes the same entry.
+static void args__cache_put(const args_ctx_t *ctx, const char *arg, args_type_t type, args_err_t err,
+                            const uint64_t value[2]) {
+  args_ctx_t *mut = (args_ctx_t *)ctx;
+  args__cache_t *cache = ARGS__LOAD(&mut->cache);
+  if (!cache) {
+    args__cache_t *fresh = (args__cache_t *)args__alloc(mut, sizeof(args__cache_t));
+    if (!fresh) return;
+    memset(fresh, 0, sizeof(*fresh));
+    // Loser of the race leaves its copy unused until the context is freed
+    cache = ARGS__CAS(&mut->cache, &cache, fresh) ? fresh : cache;
+  }
+  size_t index = args__cache_index(arg, type);
+  // Replace the last way if all are taken
+  args__cache_entry_t *entry = &cache->entries[(index + ARGS__CACHE_WAYS - 1) % ARGS_CACHE_SIZE];
+  for (size_t way = 0; way < ARGS__CACHE_WAYS; ++way) {
+    args__cache_entry_t *candidate = &cache->entries[(index + way) % ARGS_CACHE_SIZE];
+    if (!__atomic_load_n(&candidate->arg, __ATOMIC_RELAXED)) {
+      entry = candidate;
+      break;
+    }
+  }
+  uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_RELAXED);
+  if ((seq & 1) || !ARGS__CAS(&entry->seq, &seq, seq + 1)) return;
+  __atomic_store_n(&entry->arg, arg, __ATOMIC_RELAXED);
+  __atomic_store_n(&entry->type, (uint8_t)type, __ATOMIC_RELAXED);
+  __atomic_store_n(&entry->err, (uint8_t)err, __ATOMIC_RELAXED);
+  __atomic_store_n(&entry->value[0], value[0], __ATOMIC_RELAXED);
+  __atomic_store_n(&entry->value[1], value[1], __ATOMIC_RELAXED);
+  __atomic_store_n(&entry->seq, seq + 2, __ATOMIC_RELEASE);
+}
+#else
+static bool args__cache_get(const args_ctx_t *ctx, const char *arg, args_type_t type, args_err_t *err,
+                            uint64_t value[2]) {
+  (void)ctx, (void)arg, (void)type, (void)err, (void)value;
+  return false;
+}
+
+static void args__cache_put(const args_ctx_t *ctx, const char *arg, args_type_t type, args_err_t err,
+                            const uint64_t value[2]) {
+  (void)ctx, (void)arg, (void)type, (void)err, (void)value;
+}
+#endif // ARGS_CACHE_SIZE
+
+// Converted values of `tok` if `ctx` is attached to a snapshot, otherwise NULL.
+static const args__value_t *args__converted(const args_ctx_t *ctx, const args__token_t *tok) {
+  if (!ctx->values || !tok) return NULL;
+  if (tok >= ctx->tokens && tok < ctx->tokens + ctx->ntokens) return &ctx->values[tok - ctx->tokens];
+  for (const args__layer_t *layer = ctx->layers; layer; layer = layer->next)
+    if (layer->values && tok >= layer->tokens && tok < layer->tokens + layer->ntokens)
+      return &layer->values[tok - layer->tokens];
+  return NULL;
+}
+
+static args_err_t args__token_i64(const args_ctx_t *ctx, const args__token_t *tok, int64_t *out) {
+  const args__value_t *converted = args__converted(ctx, tok);
+  if (converted) {
+    if (!converted->i64_err) *out = converted->i64;
+    return (args_err_t)converted->i64_err;
+  }
+  const char *value;
+  size_t len;
+  args_err_t err = args__value(tok, &value, &len);
+  return err ? err : args__parse_i64(value, len, out);
+}
+
+static args_err_t args__token_u64(const args_ctx_t *ctx, const args__token_t *tok, uint64_t *out) {
+  const args__value_t *converted = args__converted(ctx, tok);
+  if (converted) {
+    if (!converted->u64_err) *out = converted->u64;
+    return (args_err_t)converted->u64_err;
+  }
+  const char *value;
+  size_t len;
+  args_err_t err = args__value(tok, &value, &len);
+  return err ? err : args__parse_unsigned(value, len, out);
+}
+
+static args_err_t args__token_f64(const args_ctx_t *ctx, const args__token_t *tok, double *out) {
+  const args__value_t *converted = args__converted(ctx, tok);
+  if (converted) {
+    if (!converted->f64_err) *out = converted->f64;
+    return (args_err_t)converted->f64_err;
+  }
+  const char *value;
+  size_t len;
+  args_err_t err = args__value(tok, &value, &len);
+  return err ? err : args__parse_double(value, len, out);
+}
+
+static bool args__token_bool(const args__token_t *tok) {
+  if (!tok) return false;
+  // Arg is `--flag=<value>`, only a true value is true
+  if (tok->has_eq) return args__bool_word(tok->value, tok->value_len) == 1;
+  // Arg is just a `--flag`, check if next argument is a true or false value
+  return !tok->value || args__bool_word(tok->value, tok->value_len) != 0;
+}
+
+bool args_ctx_bool(const args_ctx_t *ctx, const char *arg) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, ARGS_BOOL, &err, cached)) {
+    cached[0] = args__token_bool(args__lookup(ctx, arg, ARGS__USE_FLAG));
+    args__cache_put(ctx, arg, ARGS_BOOL, ARGS_OK, cached);
+  }
+  ARGS__STATS_END(arg);
+  return cached[0] != 0;
+}
+
+args_err_t args_ctx_int64_ex(const args_ctx_t *ctx, const char *arg, int64_t *out) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, ARGS_INT64, &err, cached)) {
+    int64_t result = 0;
+    err = args__token_i64(ctx, args__lookup(ctx, arg, ARGS__USE_VALUE), &result);
+    cached[0] = (uint64_t)result;
+    args__cache_put(ctx, arg, ARGS_INT64, err, cached);
+  }
+  if (!err) *out = (int64_t)cached[0];
+  ARGS__STATS_END(arg);
+  return err;
+}
+
+args_err_t args_ctx_uint64_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, ARGS_UINT64, &err, cached)) {
+    uint64_t result = 0;
+    err = args__token_u64(ctx, args__lookup(ctx, arg, ARGS__USE_VALUE), &result);
+    cached[0] = (uint64_t)result;
+    args__cache_put(ctx, arg, ARGS_UINT64, err, cached);
+  }
+  if (!err) *out = (uint64_t)cached[0];
+  ARGS__STATS_END(arg);
+  return err;
+}
+
+args_err_t args_ctx_int_ex(const args_ctx_t *ctx, const char *arg, int *out) {
+  int64_t value;
+  args_err_t err = args_ctx_int64_ex(ctx, arg, &value);
+  if (err) return err;
+  if (value < INT_MIN || value > INT_MAX) return ARGS_ERR_RANGE;
+  *out = (int)value;
+  return ARGS_OK;
+}
+
+args_err_t args_ctx_size_ex(const args_ctx_t *ctx, const char *arg, size_t *out) {
+  uint64_t value;
+  args_err_t err = args_ctx_uint64_ex(ctx, arg, &value);
+  if (err) return err;
+  if (value > SIZE_MAX) return ARGS_ERR_RANGE;
+  *out = (size_t)value;
+  return ARGS_OK;
+}
+
+// Bytes and durations, `type` is `ARGS_BYTES` or `ARGS_DURATION`
+static args_err_t args__scaled_ex(const args_ctx_t *ctx, const char *arg, args_type_t type, uint64_t *out) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, type, &err, cached)) {
+    const char *value;
+    size_t len;
+    err = args__value(args__lookup(ctx, arg, ARGS__USE_VALUE), &value, &len);
+    if (!err && type == ARGS_BYTES) err = args__parse_bytes(value, len, &cached[0]);
+    else if (!err) err = args__parse_duration(value, len, &cached[0]);
+    args__cache_put(ctx, arg, type, err, cached);
+  }
+  if (!err) *out = cached[0];
+  ARGS__STATS_END(arg);
+  return err;
+}
+
+args_err_t args_ctx_bytes_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out) {
+  return args__scaled_ex(ctx, arg, ARGS_BYTES, out);
+}
+
+args_err_t args_ctx_duration_ns_ex(const args_ctx_t *ctx, const char *arg, uint64_t *out) {
+  return args__scaled_ex(ctx, arg, ARGS_DURATION, out);
+}
+
+int args_ctx_int(const args_ctx_t *ctx, const char *arg) {
+  int result = 0;
+  args_ctx_int_ex(ctx, arg, &result);
+  return result;
+}
+
+int64_t args_ctx_int64(const args_ctx_t *ctx, const char *arg) {
+  int64_t result = 0;
+  args_ctx_int64_ex(ctx, arg, &result);
+  return result;
+}
+
+uint64_t args_ctx_uint64(const args_ctx_t *ctx, const char *arg) {
+  uint64_t result = 0;
+  args_ctx_uint64_ex(ctx, arg, &result);
+  return result;
+}
+
+size_t args_ctx_size(const args_ctx_t *ctx, const char *arg) {
+  size_t result = 0;
+  args_ctx_size_ex(ctx, arg, &result);
+  return result;
+}
+
+uint64_t args_ctx_bytes(const args_ctx_t *ctx, const char *arg) {
+  uint64_t result = 0;
+  args_ctx_bytes_ex(ctx, arg, &result);
+  return result;
+}
+
+uint64_t args_ctx_duration_ns(const args_ctx_t *ctx, const char *arg) {
+  uint64_t result = 0;
+  args_ctx_duration_ns_ex(ctx, arg, &result);
+  return result;
+}
+
+args_err_t args_ctx_float_ex(const args_ctx_t *ctx, const char *arg, double *out) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, ARGS_FLOAT, &err, cached)) {
+    double result = 0;
+    err = args__token_f64(ctx, args__lookup(ctx, arg, ARGS__USE_VALUE), &result);
+    memcpy(&cached[0], &result, sizeof(double));
+    args__cache_put(ctx, arg, ARGS_FLOAT, err, cached);
+  }
+  if (!err) memcpy(out, &cached[0], sizeof(double));
+  ARGS__STATS_END(arg);
+  return err;
+}
+
+double args_ctx_float(const args_ctx_t *ctx, const char *arg) {
+  double result = 0;
+  args_ctx_float_ex(ctx, arg, &result);
+  return result;
+}
+
+// String value of token with quotes stripped.
+static args_string_view_t args__token_string(const args__token_t *tok) { return tok->string; }
+
+args_string_view_t args_ctx_string_view(const args_ctx_t *ctx, const char *arg) {
+  ARGS__STATS_BEGIN();
+  uint64_t cached[2] = {0, 0};
+  args_err_t err;
+  if (!args__cache_get(ctx, arg, ARGS_STRING_VIEW, &err, cached)) {
+    const args__token_t *tok = args__lookup(ctx, arg, ARGS__USE_VALUE);
+    args_string_view_t result = tok ? args__token_string(tok) : (args_string_view_t){NULL, 0};
+    cached[0] = (uintptr_t)result.ptr;
+    cached[1] = result.len;
+    args__cache_put(ctx, arg, ARGS_STRING_VIEW, ARGS_OK, cached);
+  }
+  ARGS__STATS_END(arg);
+  return (args_string_view_t){(const char *)(uintptr_t)cached[0], (size_t)cached[1]};
+}
+
+// Hash table of `choices`, built on first use and kept until `ctx` is freed. NULL if it can't be allocated.
+static const args__choices_t *args__choices(const args_ctx_t *ctx, const char *const *choices, size_t n) {
+  args_ctx_t *mut = (args_ctx_t *)ctx;
+  args__choices_t *head = ARGS__LOAD(&mut->choices);
+  for (const args__choices_t *set = head; set; set = set->next)
+    if (set->choices == choices && set->n == n) return set;
+  size_t nslots = args__choices_slots(n);
+  args__choices_t *fresh = (args__choices_t *)args__alloc(mut, sizeof(args__choices_t) + nslots * sizeof(args__slot_t));
+  if (!fresh) return NULL;
+  args__choices_build(fresh, choices, n, (args__slot_t *)(fresh + 1));
+  // Threads racing on the same set may both add it, either copy works
+  do {
+    fresh->next = head;
+  } while (!ARGS__CAS(&mut->choices, &head, fresh));
+  return fresh;
+}
+
+args_err_t args_ctx_choice_ex(const args_ctx_t *ctx, const char *arg, const char *const *choices, size_t n, int *out) {
+  ARGS__STATS_BEGIN();
+  const args__token_t *tok = args__lookup(ctx, arg, ARGS__USE_VALUE);
+  args_err_t err = tok ? ARGS_OK : ARGS_ERR_MISSING;
+  if (!err) {
+    args_string_view_t value = args__token_string(tok);
+    const args__choices_t *set = value.ptr ? args__choices(ctx, choices, n) : NULL;
+    int index = -1;
+    if (set) index = args__choices_find(set, value.ptr, value.len);
+    else if (value.ptr) index = args__choices_scan(choices, n, value.ptr, value.len);
+    if (index < 0) err = ARGS_ERR_INVALID;
+    else *out = index;
+  }
+  ARGS__STATS_END(arg);
+  return err;
+}
+
+int args_ctx_choice(const args_ctx_t *ctx, const char *arg, const char *const *choices, size_t n) {
+  int result = -1;
+  args_ctx_choice_ex(ctx, arg, choices, n, &result);
+  return result;
+}
+
+uint32_t args_hash(const char *s, size_t len) { return args__hash(s, len); }
+
+// Keyed lookups are counted by the first variant
+#define ARGS__KEYS_ARG (nkeys ? keys[0].name : NULL)
+
+bool args_ctx_bool_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys) {
+  ARGS__STATS_BEGIN();
+  bool result = args__token_bool(args__lookup_keys(ctx, keys, nkeys, ARGS__USE_FLAG));
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return result;
+}
+
+args_err_t args_ctx_int64_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, int64_t *out) {
+  ARGS__STATS_BEGIN();
+  args_err_t err = args__token_i64(ctx, args__lookup_keys(ctx, keys, nkeys, ARGS__USE_VALUE), out);
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return err;
+}
+
+args_err_t args_ctx_uint64_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, uint64_t *out) {
+  ARGS__STATS_BEGIN();
+  args_err_t err = args__token_u64(ctx, args__lookup_keys(ctx, keys, nkeys, ARGS__USE_VALUE), out);
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return err;
+}
+
+args_err_t args_ctx_float_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, double *out) {
+  ARGS__STATS_BEGIN();
+  args_err_t err = args__token_f64(ctx, args__lookup_keys(ctx, keys, nkeys, ARGS__USE_VALUE), out);
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return err;
+}
+
+args_string_view_t args_ctx_string_view_keys(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys) {
+  ARGS__STATS_BEGIN();
+  const args__token_t *tok = args__lookup_keys(ctx, keys, nkeys, ARGS__USE_VALUE);
+  args_string_view_t result = tok ? args__token_string(tok) : (args_string_view_t){NULL, 0};
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return result;
+}
+
+args_err_t args_ctx_bool_keys_ex(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys, bool *out) {
+  ARGS__STATS_BEGIN();
+  const args__token_t *tok = args__lookup_keys(ctx, keys, nkeys, ARGS__USE_FLAG);
+  args_err_t err = !tok ? ARGS_ERR_MISSING : ARGS_OK;
+  if (tok && tok->has_eq && args__bool_word(tok->value, tok->value_len) < 0) err = ARGS_ERR_INVALID;
+  if (!err) *out = args__token_bool(tok);
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return err;
+}
+
+args_err_t args_ctx_string_view_keys_ex(const args_ctx_t *ctx, const args_key_t *keys, size_t nkeys,
+                                        args_string_view_t *out) {
+  ARGS__STATS_BEGIN();
+  const args__token_t *tok = args__lookup_keys(ctx, keys, nkeys, ARGS__USE_VALUE);
+  args_err_t err = !tok ? ARGS_ERR_MISSING : !tok->value ? ARGS_ERR_INVALID : ARGS_OK;
+  if (!err) *out = args__token_string(tok);
+  ARGS__STATS_END(ARGS__KEYS_ARG);
+  return err;
+}
+
+const char *args_ctx_string(const args_ctx_t *ctx, const char *arg) {
+  args_string_view_t view = args_ctx_string_view(ctx, arg);
+  // Terminate quoted value in place
+  if (view.ptr && view.ptr[view.len]) ((char *)view.ptr)[view.len] = '\0';
+  return view.ptr;
+}
+
+typedef enum {
+  ARGS__LIST_INT,
+  ARGS__LIST_FLOAT,
+  ARGS__LIST_STRING,
+} args__list_type_t;
+
+// Memoized result of a list access function.
+typedef struct args__list {
+  struct args__list *next;
+  const char *arg;
+  args__list_type_t type;
+  void *items;
+  size_t count;
+} args__list_t;
+
+static int args__compare_int(const void *a, const void *b) { return *(const int *)a - *(const int *)b; }
+
+// Collect values of all tokens matching `arg` into one array.
+// Find the last token of `flag` on the command line if `layer` is NULL, or in `layer`.
+static int args__list_find(const args_ctx_t *ctx, const args__layer_t *layer, const char *flag, size_t len) {
+  return layer ? args__layer_find(layer, flag, len) : args__find(ctx, flag, len, args__hash(flag, len));
+}
+
+static bool args__list_find_any(const args_ctx_t *ctx, const args__layer_t *layer, const char *arg) {
+  const char *flag;
+  size_t len;
+  while ((flag = args__next_alias(&arg, &len)))
+    if (args__list_find(ctx, layer, flag, len) >= 0) return true;
+  return false;
+}
+
+// Position of an item: token index into `order` and start of the item in its value.
+typedef struct {
+  size_t token;
+  const char *p;
+} args__list_pos_t;
+
+// Items of int or float list from `from` up to `to`, written to `items` from `first` on.
+typedef struct {
+  const args__token_t *tokens;
+  const int *order;
+  size_t ntokens;
+  args__list_type_t type;
+  void *items;
+  args__list_pos_t from, to;
+  size_t first;
+  args_err_t err;
+} args__list_chunk_t;
+
+static args_err_t args__convert(args__list_chunk_t *chunk) {
+  size_t n = chunk->first;
+  for (size_t i = chunk->from.token; i < chunk->ntokens && i <= chunk->to.token; ++i) {
+    const args__token_t *tok = &chunk->tokens[chunk->order[i]];
+    const char *end = tok->value + tok->value_len;
+    for (const char *p = i == chunk->from.token ? chunk->from.p : tok->value;; ++p) {
+      if (i == chunk->to.token && p == chunk->to.p) return ARGS_OK;
+      const char *comma = args__find_byte(p, end, ',');
+      args_err_t err = chunk->type == ARGS__LIST_INT ? args__parse_i64(p, comma - p, (int64_t *)chunk->items + n)
+                                                     : args__parse_double(p, comma - p, (double *)chunk->items + n);
+      if (err) return chunk->err = err;
+      n++;
+      if ((p = comma) == end) break;
+    }
+  }
+  return ARGS_OK;
+}
+
+#ifdef ARGS__THREADS
+#ifndef ARGS_THREADS_MIN_ITEMS
+#define ARGS_THREADS_MIN_ITEMS 16384
+#endif // ARGS_THREADS_MIN_ITEMS
+
+#define ARGS__MAX_THREADS 64
+
+static void *args__convert_worker(void *chunk) {
+  args__convert((args__list_chunk_t *)chunk);
+  return NULL;
+}
+
+// Split `count` items of `all` into chunks of about equal length at commas and convert them on `threads` threads.
+// Finding the commas is a byte search, conversion is the expensive part that runs in parallel.
+static args_err_t args__convert_parallel(const args__list_chunk_t *all, size_t count, size_t threads) {
+  args__list_chunk_t chunks[ARGS__MAX_THREADS];
+  pthread_t workers[ARGS__MAX_THREADS];
+  size_t nchunks = threads < ARGS__MAX_THREADS ? threads : ARGS__MAX_THREADS, per = count / nchunks, c = 1, n = 0;
+  chunks[0] = *all;
+  for (size_t i = 0; i < all->ntokens && c < nchunks; ++i) {
+    const args__token_t *tok = &all->tokens[all->order[i]];
+    const char *end = tok->value + tok->value_len;
+    for (const char *p = tok->value; c < nchunks; ++p) {
+      if (n == c * per) {
+        chunks[c] = *all;
+        chunks[c].from = chunks[c - 1].to = (args__list_pos_t){i, p};
+        chunks[c].first = n;
+        chunks[c++].to = all->to;
+      }
+      n++;
+      if ((p = args__find_byte(p, end, ',')) == end) break;
+    }
+  }
+  // Chunks without a thread are converted here
+  size_t started = 1;
+  while (started < c && !pthread_create(&workers[started], NULL, args__convert_worker, &chunks[started])) started++;
+  for (size_t i = started; i < c; ++i) args__convert(&chunks[i]);
+  args__convert(&chunks[0]);
+  args_err_t err = chunks[0].err;
+  for (size_t i = 1; i < c; ++i) {
+    if (i < started) pthread_join(workers[i], NULL);
+    if (!err) err = chunks[i].err;
+  }
+  return err;
+}
+#endif // ARGS__THREADS
+
+// Build list of `arg`. Returns NULL if out of memory, then `*count` is the number of items that didn't fit.
+static args__list_t *args__build_list(args_ctx_t *ctx, const char *arg, args__list_type_t type, size_t *count) {
+  static const size_t item_size[] = {sizeof(int64_t), sizeof(double), sizeof(args_string_view_t)};
+  // Values come from the command line, or from the first layer that has the argument
+  const args__layer_t *layer = NULL;
+  if (!args__list_find_any(ctx, NULL, arg))
+    for (layer = ctx->layers; layer && !args__list_find_any(ctx, layer, arg); layer = layer->next);
+  const args__token_t *tokens = layer ? layer->tokens : ctx->tokens;
+  // Count matching tokens and their values
+  size_t ntokens = 0, n = 0;
+  const char *spec = arg, *flag;
+  size_t len;
+  bool multiple = false, valid = true;
+  while ((flag = args__next_alias(&spec, &len))) {
+    int first = args__list_find(ctx, layer, flag, len);
+    if (!layer) args__consume_chain(ctx, first, ARGS__USE_VALUE);
+    if (first >= 0 && ntokens) multiple = true;
+    for (int i = first; i >= 0 && valid; i = tokens[i].prev) {
+      const args__token_t *tok = &tokens[i];
+      valid = tok->value != NULL;
+      ntokens++;
+      n++;
+      if (!valid || type == ARGS__LIST_STRING) continue;
+      const char *end = tok->value + tok->value_len;
+      for (const char *p = tok->value; (p = args__find_byte(p, end, ',')) != end; ++p) n++;
+    }
+  }
+  *count = valid ? n : 0;
+  args__list_t *list = (args__list_t *)args__alloc(ctx, sizeof(args__list_t));
+  if (!list) return NULL;
+  memset(list, 0, sizeof(*list));
+  list->arg = arg;
+  list->type = type;
+  if (!*count) return list;
+  // Token indices are followed by items
+  int *order = (int *)args__alloc(ctx, ntokens * sizeof(int));
+  unsigned char *items = (unsigned char *)args__alloc(ctx, *count * item_size[type]);
+  if (!order || !items) return NULL;
+  n = 0;
+  spec = arg;
+  while ((flag = args__next_alias(&spec, &len)))
+    for (int i = args__list_find(ctx, layer, flag, len); i >= 0; i = tokens[i].prev) order[n++] = i;
+  // Every chain goes from the last occurrence to the first one
+  if (multiple) args__sort(order, ntokens, sizeof(int), args__compare_int);
+  else
+    for (size_t i = 0; i < ntokens / 2; ++i) {
+      int tmp = order[i];
+      order[i] = order[ntokens - 1 - i];
+      order[ntokens - 1 - i] = tmp;
+    }
+  // Convert values
+  if (type == ARGS__LIST_STRING) {
+    for (size_t i = 0; i < ntokens; ++i) ((args_string_view_t *)items)[i] = args__token_string(&tokens[order[i]]);
+  } else {
+    args__list_chunk_t chunk = {tokens, order, ntokens, type, items, {0, tokens[order[0]].value}, {ntokens, NULL},
+                                0, ARGS_OK};
+#ifdef ARGS__THREADS
+    if (ctx->threads > 1 && *count >= ARGS_THREADS_MIN_ITEMS) {
+      if (args__convert_parallel(&chunk, *count, ctx->threads)) *count = 0;
+    } else
+#endif // ARGS__THREADS
+      if (args__convert(&chunk)) *count = 0;
+  }
+  list->items = *count ? items : NULL;
+  list->count = *count;
+  return list;
+}
+
+// Get memoized list or build and publish a new one.
+static const void *args__list(const args_ctx_t *ctx, const char *arg, args__list_type_t type, size_t *count) {
+  ARGS__STATS_BEGIN();
+  args_ctx_t *mut = (args_ctx_t *)ctx;
+  args__list_t *head = ARGS__LOAD(&mut->lists), *list;
+  for (list = head; list; list = list->next)
+    if (list->arg == arg && list->type == type) break;
+  if (list) {
+    ARGS__STATS_ADD(cache_hits, 1);
+  } else if ((list = args__build_list(mut, arg, type, count))) {
+    // Another thread could've published the same list in the meantime, that's harmless
+    list->next = head;
+    while (!ARGS__CAS(&mut->lists, &list->next, list));
+  }
+  // Out of memory is not memoized, `*count` is left as set by `args__build_list()`
+  if (list) *count = list->count;
+  ARGS__STATS_END(arg);
+  return list ? list->items : NULL;
+}
+
+const int64_t *args_ctx_int_list(const args_ctx_t *ctx, const char *arg, size_t *count) {
+  return (const int64_t *)args__list(ctx, arg, ARGS__LIST_INT, count);
+}
+
+const double *args_ctx_float_list(const args_ctx_t *ctx, const char *arg, size_t *count) {
+  return (const double *)args__list(ctx, arg, ARGS__LIST_FLOAT, count);
+}
+
+const args_string_view_t *args_ctx_string_list(const args_ctx_t *ctx, const char *arg, size_t *count) {
+  return (const args_string_view_t *)args__list(ctx, arg, ARGS__LIST_STRING, count);
+}
+
+// Entry of the hash table built from a spec table.
+typedef struct {
+  const char *name;
+  size_t len;
+  uint32_t hash;
+  int spec; // -1 if empty
+} args__spec_slot_t;
+
+// Spec tables of up to half as many variants are hashed on the stack
+#define ARGS__SPEC_STACK_SLOTS 64
+
+// Write value of `type` parsed from `value` to `dst`.
+static args_err_t args__store(args_type_t type, const char *value, size_t len, void *dst) {
+  args_err_t err = ARGS_OK;
+  int64_t i64;
+  uint64_t u64;
+  switch (type) {
+  case ARGS_BOOL: {
+    int word = args__bool_word(value, len);
+    if (word < 0) return ARGS_ERR_INVALID;
+    *(bool *)dst = word == 1;
+    break;
+  }
+  case ARGS_INT:
+    if (!(err = args__parse_i64(value, len, &i64))) {
+      if (i64 < INT_MIN || i64 > INT_MAX) return ARGS_ERR_RANGE;
+      *(int *)dst = (int)i64;
+    }
+    break;
+  case ARGS_INT64: err = args__parse_i64(value, len, (int64_t *)dst); break;
+  case ARGS_UINT64: err = args__parse_unsigned(value, len, (uint64_t *)dst); break;
+  case ARGS_SIZE:
+    if (!(err = args__parse_unsigned(value, len, &u64))) {
+      if (u64 > SIZE_MAX) return ARGS_ERR_RANGE;
+      *(size_t *)dst = (size_t)u64;
+    }
+    break;
+  case ARGS_FLOAT: err = args__parse_double(value, len, (double *)dst); break;
+  case ARGS_BYTES: err = args__parse_bytes(value, len, (uint64_t *)dst); break;
+  case ARGS_DURATION: err = args__parse_duration(value, len, (uint64_t *)dst); break;
+  case ARGS_STRING: *(const char **)dst = value; break;
+  case ARGS_STRING_VIEW: *(args_string_view_t *)dst = (args_string_view_t){value, len}; break;
+  }
+  return err;
+}
+
+// Write value of `tok` to `dst`.
+static args_err_t args__store_token(args_type_t type, const args__token_t *tok, void *dst) {
+  if (type == ARGS_BOOL) {
+    // Value of `--flag=<value>` must be a boolean word, `--flag <other>` is just true
+    if (tok->has_eq && args__bool_word(tok->value, tok->value_len) < 0) return ARGS_ERR_INVALID;
+    *(bool *)dst = args__token_bool(tok);
+    return ARGS_OK;
+  }
+  if (type == ARGS_STRING || type == ARGS_STRING_VIEW) {
+    args_string_view_t view = args__token_string(tok);
+    if (!view.ptr) return ARGS_ERR_INVALID;
+    if (type == ARGS_STRING_VIEW) *(args_string_view_t *)dst = view;
+    else {
+      // Terminate quoted value in place, same as `args_string()`
+      if (view.ptr[view.len]) ((char *)view.ptr)[view.len] = '\0';
+      *(const char **)dst = view.ptr;
+    }
+    return ARGS_OK;
+  }
+  const char *value;
+  size_t len;
+  args_err_t err = args__value(tok, &value, &len);
+  return err ? err : args__store(type, value, len, dst);
+}
+
+// Store values found in layers, from the lowest priority to the highest one.
+static void args__parse_layers(const args__layer_t *layer, const args_spec_t *spec, size_t nspec, void *out,
+                               args_err_t *result) {
+  if (!layer) return;
+  args__parse_layers(layer->next, spec, nspec, out, result);
+  for (size_t i = 0; i < nspec; ++i) {
+    int found = -1;
+    const char *name = spec[i].name, *flag;
+    size_t len;
+    while ((flag = args__next_alias(&name, &len))) {
+      int t = args__layer_find(layer, flag, len);
+      if (t > found) found = t;
+    }
+    if (found < 0) continue;
+    args_err_t err = args__store_token(spec[i].type, &layer->tokens[found], (unsigned char *)out + spec[i].offset);
+    if (err && !*result) *result = err;
+  }
+}
+
+args_err_t args_ctx_parse_into(const args_ctx_t *ctx, const args_spec_t *spec, size_t nspec, void *out) {
+  args_err_t result = ARGS_OK, err;
+  // Defaults
+  size_t naliases = 0;
+  for (size_t i = 0; i < nspec; ++i) {
+    const char *value = spec[i].value;
+    // Missing default is zero value of the type
+    if (!value && spec[i].type != ARGS_STRING && spec[i].type != ARGS_STRING_VIEW) value = "0";
+    err = args__store(spec[i].type, value, value ? strlen(value) : 0, (unsigned char *)out + spec[i].offset);
+    if (err && !result) result = err;
+    const char *name = spec[i].name;
+    size_t len;
+    while (args__next_alias(&name, &len)) naliases++;
+  }
+  args__parse_layers(ctx->layers, spec, nspec, out, &result);
+  if (!ctx->ntokens || !naliases) return result;
+  // Hash table of all variants, at most half full
+  size_t nslots = 8;
+  while (nslots < naliases * 2) nslots <<= 1;
+  args__spec_slot_t stack[ARGS__SPEC_STACK_SLOTS], *slots = stack;
+  // Larger tables are scratch memory freed before return, so repeated calls don't grow `ctx`
+  if (nslots > ARGS__SPEC_STACK_SLOTS) slots = (args__spec_slot_t *)ARGS_MALLOC(nslots * sizeof(args__spec_slot_t));
+  if (!slots) return ARGS_ERR_NOMEM;
+  for (size_t i = 0; i < nslots; ++i) slots[i].spec = -1;
+  for (size_t i = 0; i < nspec; ++i) {
+    const char *name = spec[i].name, *flag;
+    size_t len;
+    while ((flag = args__next_alias(&name, &len))) {
+      uint32_t hash = args__hash(flag, len);
+      size_t j = hash & (nslots - 1);
+      while (slots[j].spec >= 0 && !(slots[j].len == len && !memcmp(slots[j].name, flag, len)))
+        j = (j + 1) & (nslots - 1);
+      // First spec entry wins if variant is given twice
+      if (slots[j].spec >= 0) continue;
+      slots[j] = (args__spec_slot_t){flag, len, hash, (int)i};
+    }
+  }
+  // Single pass over the tokens, later occurrences overwrite earlier ones
+  ARGS__STATS_ADD(scanned, ctx->ntokens);
+  for (size_t t = 0; t < ctx->ntokens; ++t) {
+    const args__token_t *tok = &ctx->tokens[t];
+    size_t j = tok->hash & (nslots - 1);
+    for (; slots[j].spec >= 0; j = (j + 1) & (nslots - 1)) {
+      if (slots[j].hash != tok->hash || slots[j].len != tok->key_len || memcmp(slots[j].name, tok->key, tok->key_len))
+        continue;
+      const args_spec_t *entry = &spec[slots[j].spec];
+      args__consume(ctx, t, entry->type == ARGS_BOOL ? ARGS__USE_FLAG : ARGS__USE_VALUE);
+      err = args__store_token(entry->type, tok, (unsigned char *)out + entry->offset);
+      if (err && !result) result = err;
+      break;
+    }
+  }
+  if (slots != stack) ARGS_FREE(slots);
+  return result;
+}
+
+// Registered flag, registry is a list in reverse order.
+typedef struct args__flag {
+  struct args__flag *next;
+  const char *arg;
+  int id;
+} args__flag_t;
+
+// Single variant of a registered flag.
+typedef struct {
+  const char *name;
+  size_t len;
+  uint32_t hash;
+  int flag;
+} args__variant_t;
+
+// Minimal perfect hash in "hash and displace" form.
+// Key goes to bucket `mix(hash ^ seed) % nbuckets`. Bucket's `disp` is either `-(slot + 1)` of its only key,
+// or displacement `d` for which all of its keys land in distinct slots `mix(hash ^ seed ^ d * K) % n`.
+typedef struct args__mph {
+  uint32_t n;
+  uint32_t nbuckets;
+  uint32_t seed;
+  int32_t *disp;
+  args__variant_t *keys;
+} args__mph_t;
+
+// Murmur3 finalizer
+static uint32_t args__mix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+static uint32_t args__mph_bucket(const args__mph_t *mph, uint32_t hash) {
+  return args__mix(hash ^ mph->seed) % mph->nbuckets;
+}
+
+static uint32_t args__mph_slot(const args__mph_t *mph, uint32_t hash, uint32_t d) {
+  return args__mix(hash ^ mph->seed ^ (d * 0x9E3779B9u)) % mph->n;
+}
+
+// Get id of the flag with the given variant, or -1.
+static int args__mph_find(const args__mph_t *mph, const char *key, size_t len, uint32_t hash) {
+  if (!mph) return -1;
+  int32_t d = mph->disp[args__mph_bucket(mph, hash)];
+  const args__variant_t *v = &mph->keys[d < 0 ? (uint32_t)(-d - 1) : args__mph_slot(mph, hash, d)];
+  return v->hash == hash && v->len == len && !memcmp(v->name, key, len) ? v->flag : -1;
+}
+
+static int args__compare_variant(const void *a, const void *b) {
+  const args__variant_t *x = (const args__variant_t *)a, *y = (const args__variant_t *)b;
+  if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+  if (x->len != y->len) return x->len < y->len ? -1 : 1;
+  int cmp = memcmp(x->name, y->name, x->len);
+  // Keep the first registered flag first
+  return cmp ? cmp : x->flag - y->flag;
+}
+
+// Sorts variants by name, so that the ones with a common prefix are adjacent.
+static int args__compare_name(const void *a, const void *b) {
+  const args__variant_t *x = (const args__variant_t *)a, *y = (const args__variant_t *)b;
+  int cmp = memcmp(x->name, y->name, x->len < y->len ? x->len : y->len);
+  return cmp ? cmp : (x->len > y->len) - (x->len < y->len);
+}
+
+// Trie of registered variants in one array. Children of a node are contiguous and sorted by `c`,
+// and variants starting with the prefix of a node are the range `lo` to `hi` of variants sorted by name.
+typedef struct {
+  uint32_t child; // Index of the first child
+  uint32_t nchildren;
+  uint32_t lo, hi;
+  uint32_t depth; // Length of the prefix
+  int flag;       // Id of the flag all variants of the range belong to, or -1 if there are several
+  unsigned char c;
+} args__trie_node_t;
+
+typedef struct args__trie {
+  args__trie_node_t *nodes;
+  uint32_t nnodes;
+  const args__variant_t *vars;
+} args__trie_t;
+
+// Build trie of `n` variants sorted by name, breadth first, so that children are appended together.
+static args__trie_t *args__trie_build(args_ctx_t *ctx, const args__variant_t *vars, uint32_t n) {
+  size_t max_nodes = 1;
+  for (uint32_t i = 0; i < n; ++i) max_nodes += vars[i].len;
+  args__trie_t *trie = (args__trie_t *)args__alloc(ctx, sizeof(args__trie_t));
+  args__trie_node_t *nodes = (args__trie_node_t *)args__alloc(ctx, max_nodes * sizeof(args__trie_node_t));
+  if (!trie || !nodes || max_nodes > UINT32_MAX) return NULL;
+  nodes[0] = (args__trie_node_t){0, 0, 0, n, 0, -1, 0};
+  uint32_t nnodes = 1;
+  for (uint32_t q = 0; q < nnodes; ++q) {
+    args__trie_node_t *node = &nodes[q];
+    node->child = nnodes;
+    uint32_t depth = node->depth, i = node->lo;
+    // Variant equal to the prefix sorts first
+    while (i < node->hi && vars[i].len == depth) i++;
+    while (i < node->hi) {
+      unsigned char c = (unsigned char)vars[i].name[depth];
+      uint32_t start = i;
+      int flag = vars[i].flag;
+      for (; i < node->hi && (unsigned char)vars[i].name[depth] == c; ++i)
+        if (vars[i].flag != flag) flag = -1;
+      nodes[nnodes++] = (args__trie_node_t){0, 0, start, i, depth + 1, flag, c};
+    }
+    node->nchildren = nnodes - node->child;
+  }
+  trie->nodes = nodes;
+  trie->nnodes = nnodes;
+  trie->vars = vars;
+  return trie;
+}
+
+static uint32_t args__trie_child(const args__trie_t *trie, uint32_t node, unsigned char c) {
+  const args__trie_node_t *parent = &trie->nodes[node];
+  for (uint32_t i = parent->child; i < parent->child + parent->nchildren; ++i)
+    if (trie->nodes[i].c >= c) return trie->nodes[i].c == c ? i : 0;
+  return 0;
+}
+
+// Node with prefix `key`, or 0 (the root) if there is none.
+static uint32_t args__trie_walk(const args__trie_t *trie, const char *key, size_t len) {
+  uint32_t node = 0;
+  for (size_t i = 0; i < len; ++i)
+    if (!(node = args__trie_child(trie, node, (unsigned char)key[i]))) return 0;
+  return node;
+}
+
+// Longest token and variant compared by `args_suggest()`
+#define ARGS__SUGGEST_LEN 64
+
+// Depth first search for the variant nearest to `key`, rows of the edit distance matrix are shared by prefixes.
+// `rows[depth]` of the node is filled in.
+static void args__trie_nearest(const args__trie_t *trie, uint32_t node, const char *key, size_t len,
+                               uint8_t rows[][ARGS__SUGGEST_LEN + 1], size_t max, size_t *best, uint32_t *best_var) {
+  const args__trie_node_t *n = &trie->nodes[node];
+  const uint8_t *row = rows[n->depth];
+  if (n->lo < n->hi && trie->vars[n->lo].len == n->depth && row[len] < *best) {
+    *best = row[len];
+    *best_var = n->lo;
+  }
+  if (n->depth == ARGS__SUGGEST_LEN) return;
+  for (uint32_t i = n->child; i < n->child + n->nchildren; ++i) {
+    uint8_t *next = rows[n->depth + 1];
+    uint8_t low = next[0] = (uint8_t)(n->depth + 1);
+    for (size_t j = 1; j <= len; ++j) {
+      uint8_t cost = row[j - 1] + ((unsigned char)key[j - 1] != trie->nodes[i].c);
+      if (row[j] + 1 < cost) cost = row[j] + 1;
+      if (next[j - 1] + 1 < cost) cost = next[j - 1] + 1;
+      next[j] = cost;
+      if (cost < low) low = cost;
+    }
+    // Every longer prefix is at least as far
+    if (low <= max) args__trie_nearest(trie, i, key, len, rows, max, best, best_var);
+  }
+}
+
+// Try to place all `n` variants with the given seed.
+static bool args__mph_place(args__mph_t *mph, const args__variant_t *vars, uint32_t *bucket_of, uint32_t *start,
+                            uint32_t *members, uint32_t *order, bool *taken) {
+  const uint32_t n = mph->n, nbuckets = mph->nbuckets;
+  // Group variants by bucket
+  memset(start, 0, (nbuckets + 1) * sizeof(uint32_t));
+  for (uint32_t i = 0; i < n; ++i) start[(bucket_of[i] = args__mph_bucket(mph, vars[i].hash)) + 1]++;
+  for (uint32_t b = 0; b < nbuckets; ++b) start[b + 1] += start[b];
+  for (uint32_t i = 0; i < n; ++i) members[start[bucket_of[i]]++] = i;
+  for (uint32_t b = nbuckets; b > 0; --b) start[b] = start[b - 1];
+  start[0] = 0;
+  // Order buckets from the largest to the smallest
+  uint32_t max_size = 0, k = 0;
+  for (uint32_t b = 0; b < nbuckets; ++b)
+    if (start[b + 1] - start[b] > max_size) max_size = start[b + 1] - start[b];
+  for (uint32_t size = max_size; size > 0; --size)
+    for (uint32_t b = 0; b < nbuckets; ++b)
+      if (start[b + 1] - start[b] == size) order[k++] = b;
+  memset(taken, 0, n * sizeof(bool));
+  for (uint32_t b = 0; b < nbuckets; ++b) mph->disp[b] = 0;
+  uint32_t free_slot = 0;
+  for (uint32_t o = 0; o < k; ++o) {
+    uint32_t b = order[o], size = start[b + 1] - start[b];
+    const uint32_t *keys = members + start[b];
+    if (size == 1) {
+      while (taken[free_slot]) free_slot++;
+      taken[free_slot] = true;
+      mph->keys[free_slot] = vars[keys[0]];
+      mph->disp[b] = -(int32_t)free_slot - 1;
+      continue;
+    }
+    uint32_t d = 1;
+    for (;; ++d) {
+      if (d > 1000000) return false;
+      uint32_t i = 0;
+      for (; i < size; ++i) {
+        uint32_t slot = args__mph_slot(mph, vars[keys[i]].hash, d);
+        if (taken[slot]) break;
+        taken[slot] = true;
+      }
+      if (i == size) break;
+      // Undo
+      while (i-- > 0) taken[args__mph_slot(mph, vars[keys[i]].hash, d)] = false;
+    }
+    mph->disp[b] = (int32_t)d;
+    for (uint32_t i = 0; i < size; ++i) mph->keys[args__mph_slot(mph, vars[keys[i]].hash, d)] = vars[keys[i]];
+  }
+  return true;
+}
+
+int args_ctx_register(args_ctx_t *ctx, const char *arg) {
+  if (ctx->mph) return -1;
+  args__flag_t *flag = (args__flag_t *)args__alloc(ctx, sizeof(args__flag_t));
+  if (!flag) return -1;
+  flag->arg = arg;
+  flag->id = ctx->nflags++;
+  flag->next = ctx->flags;
+  ctx->flags = flag;
+  return flag->id;
+}
+
+bool args_ctx_freeze(args_ctx_t *ctx) {
+  if (ctx->mph) return true;
+  // Collect variants
+  uint32_t n = 0;
+  for (args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg;
+    size_t len;
+    while (args__next_alias(&arg, &len)) n++;
+  }
+  if (!n) return true;
+  args__variant_t *vars = (args__variant_t *)args__alloc(ctx, n * sizeof(args__variant_t));
+  if (!vars) return false;
+  n = 0;
+  for (args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg, *name;
+    size_t len;
+    while ((name = args__next_alias(&arg, &len))) {
+      args__variant_t *v = &vars[n++];
+      v->name = name;
+      v->len = len;
+      v->hash = args__hash(name, len);
+      v->flag = flag->id;
+    }
+  }
+  // Drop duplicate variants, so that every key is unique
+  args__sort(vars, n, sizeof(args__variant_t), args__compare_variant);
+  uint32_t unique = 0;
+  for (uint32_t i = 0; i < n; ++i) {
+    const args__variant_t *last = unique ? &vars[unique - 1] : NULL;
+    if (last && last->hash == vars[i].hash && last->len == vars[i].len && !memcmp(last->name, vars[i].name, last->len))
+      continue;
+    vars[unique++] = vars[i];
+  }
+  n = unique;
+  args__mph_t *mph = (args__mph_t *)args__alloc(ctx, sizeof(args__mph_t));
+  if (!mph) return false;
+  mph->n = n;
+  mph->nbuckets = n / 2 + 1;
+  mph->disp = (int32_t *)args__alloc(ctx, mph->nbuckets * sizeof(int32_t));
+  mph->keys = (args__variant_t *)args__alloc(ctx, n * sizeof(args__variant_t));
+  // Scratch memory for placement
+  uint32_t *bucket_of = (uint32_t *)args__alloc(ctx, n * sizeof(uint32_t));
+  uint32_t *start = (uint32_t *)args__alloc(ctx, (mph->nbuckets + 1) * sizeof(uint32_t));
+  uint32_t *members = (uint32_t *)args__alloc(ctx, n * sizeof(uint32_t));
+  uint32_t *order = (uint32_t *)args__alloc(ctx, mph->nbuckets * sizeof(uint32_t));
+  bool *taken = (bool *)args__alloc(ctx, n * sizeof(bool));
+  if (!mph->disp || !mph->keys || !bucket_of || !start || !members || !order || !taken) return false;
+  bool placed = false;
+  // Variants with equal 32-bit hashes can't be separated by any seed
+  for (uint32_t i = 1; i < n; ++i)
+    if (vars[i - 1].hash == vars[i].hash) return false;
+  for (uint32_t attempt = 0; attempt < 16 && !placed; ++attempt) {
+    mph->seed = args__mix(attempt * 0x9E3779B9u + 1);
+    placed = args__mph_place(mph, vars, bucket_of, start, members, order, taken);
+  }
+  if (!placed) return false;
+  // Trie has its own copy, sorted by name
+  args__variant_t *sorted = (args__variant_t *)args__alloc(ctx, n * sizeof(args__variant_t));
+  if (!sorted) return false;
+  memcpy(sorted, vars, n * sizeof(args__variant_t));
+  args__sort(sorted, n, sizeof(args__variant_t), args__compare_name);
+  args__trie_t *trie = args__trie_build(ctx, sorted, n);
+  if (!trie) return false;
+  ctx->trie = trie;
+  ctx->mph = mph;
+  // Classify every argument
+  for (size_t i = 0; i < ctx->ntokens; ++i) {
+    args__token_t *tok = &ctx->tokens[i];
+    tok->flag = args__mph_find(mph, tok->key, tok->key_len, tok->hash);
+  }
+  return true;
+}
+
+int args_ctx_classify(const args_ctx_t *ctx, const char *token) {
+  args__scan_t scan;
+  args__scan(token, &scan);
+  return args__mph_find(ctx->mph, token, scan.eq, args__hash(token, scan.eq));
+}
+
+// Id of the flag abbreviated by `key`, or -1.
+static int args__abbrev_flag(const args_ctx_t *ctx, const char *key, size_t len) {
+  if (!ctx->trie || len <= 2 || key[0] != '-' || key[1] != '-') return -1;
+  uint32_t node = args__trie_walk(ctx->trie, key, len);
+  return node ? ctx->trie->nodes[node].flag : -1;
+}
+
+int args_ctx_resolve(const args_ctx_t *ctx, const char *token) {
+  args__scan_t scan;
+  args__scan(token, &scan);
+  int flag = args__mph_find(ctx->mph, token, scan.eq, args__hash(token, scan.eq));
+  return flag >= 0 ? flag : args__abbrev_flag(ctx, token, scan.eq);
+}
+
+size_t args_ctx_abbreviate(args_ctx_t *ctx) {
+  if (!ctx->trie || ctx->abbrevs || !ctx->ntokens) return 0;
+  int *last = (int *)args__alloc(ctx, ctx->nflags * sizeof(int));
+  int *prev = (int *)args__alloc(ctx, ctx->ntokens * sizeof(int));
+  if (!last || !prev) return 0;
+  for (int f = 0; f < ctx->nflags; ++f) last[f] = -1;
+  for (size_t i = 0; i < ctx->ntokens; ++i) prev[i] = -1;
+  // Link arguments of every abbreviated flag
+  size_t count = 0;
+  for (size_t i = 0; i < ctx->ntokens; ++i) {
+    args__token_t *tok = &ctx->tokens[i];
+    if (tok->key_len == 2 && !tok->has_eq && tok->key[0] == '-' && tok->key[1] == '-') break;
+    if (tok->source >= 0 || tok->flag >= 0) continue;
+    int flag = args__abbrev_flag(ctx, tok->key, tok->key_len);
+    if (flag < 0) continue;
+    tok->flag = flag;
+    prev[i] = last[flag];
+    last[flag] = (int)i;
+    count++;
+  }
+  if (!count) return 0;
+  // Table of every variant of the abbreviated flags, at most half full
+  size_t nvars = 0;
+  for (const args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg;
+    size_t len;
+    if (last[flag->id] >= 0)
+      while (args__next_alias(&arg, &len)) nvars++;
+  }
+  size_t nentries = 2;
+  while (nentries < 2 * nvars) nentries <<= 1;
+  args__abbrevs_t *abbrevs = (args__abbrevs_t *)args__alloc(ctx, sizeof(args__abbrevs_t));
+  args__abbrev_t *entries = (args__abbrev_t *)args__alloc(ctx, nentries * sizeof(args__abbrev_t));
+  if (!abbrevs || !entries) return 0;
+  memset(entries, 0, nentries * sizeof(args__abbrev_t));
+  for (const args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg, *name;
+    size_t len;
+    while (last[flag->id] >= 0 && (name = args__next_alias(&arg, &len))) {
+      uint32_t hash = args__hash(name, len);
+      size_t i = hash & (nentries - 1);
+      while (entries[i].name && (entries[i].len != len || memcmp(entries[i].name, name, len)))
+        i = (i + 1) & (nentries - 1);
+      // Variant registered by several flags keeps the first one
+      if (!entries[i].name) entries[i] = (args__abbrev_t){name, len, hash, last[flag->id], 0};
+    }
+  }
+  abbrevs->entries = entries;
+  abbrevs->mask = nentries - 1;
+  abbrevs->prev = prev;
+  ctx->abbrevs = abbrevs;
+  return count;
+}
+
+args_string_view_t args_ctx_suggest(const args_ctx_t *ctx, const char *token) {
+  const args__trie_t *trie = ctx->trie;
+  args__scan_t scan;
+  args__scan(token, &scan);
+  size_t len = scan.eq;
+  if (!trie || len > ARGS__SUGGEST_LEN) return (args_string_view_t){NULL, 0};
+  // Abbreviation is closer than any typo
+  uint32_t node = (len > 2 && token[0] == '-' && token[1] == '-') ? args__trie_walk(trie, token, len) : 0;
+  uint32_t best_var = 0;
+  if (node && trie->nodes[node].flag >= 0) best_var = trie->nodes[node].lo;
+  else {
+    uint8_t rows[ARGS__SUGGEST_LEN + 1][ARGS__SUGGEST_LEN + 1];
+    size_t max = len < 4 ? 0 : len <= 5 ? 1 : 2, best = max + 1;
+    for (size_t j = 0; j <= len; ++j) rows[0][j] = (uint8_t)j;
+    args__trie_nearest(trie, 0, token, len, rows, max, &best, &best_var);
+    if (best > max) return (args_string_view_t){NULL, 0};
+  }
+  return (args_string_view_t){trie->vars[best_var].name, trie->vars[best_var].len};
+}
+
+static void args__complete(const args_ctx_t *ctx, const char *line, size_t point, args__out_t *out) {
+  size_t len = strlen(line);
+  if (point > len) point = len;
+  size_t start = point;
+  while (start > 0 && line[start - 1] != ' ' && line[start - 1] != '\t') start--;
+  const char *word = line + start;
+  size_t word_len = point - start;
+  if (!word_len || word[0] != '-' || memchr(word, '=', word_len)) return;
+  // Registry is small and completion runs once per process, so variants are sorted on the spot
+  size_t n = 0;
+  for (const args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg;
+    size_t variant_len;
+    while (args__next_alias(&arg, &variant_len)) n++;
+  }
+  // Scratch memory, `ctx` stays untouched
+  args__variant_t *vars = n ? (args__variant_t *)ARGS_MALLOC(n * sizeof(args__variant_t)) : NULL;
+  if (!vars) return;
+  n = 0;
+  for (const args__flag_t *flag = ctx->flags; flag; flag = flag->next) {
+    const char *arg = flag->arg, *name;
+    size_t variant_len;
+    while ((name = args__next_alias(&arg, &variant_len)))
+      vars[n++] = (args__variant_t){name, variant_len, 0, flag->id};
+  }
+  args__sort(vars, n, sizeof(args__variant_t), args__compare_name);
+  // First variant not less than `word`
+  args__variant_t key = {word, word_len, 0, -1};
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (args__compare_name(&vars[mid], &key) < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  for (size_t i = lo; i < n && vars[i].len >= word_len && !memcmp(vars[i].name, word, word_len); ++i) {
+    if (i > lo && !args__compare_name(&vars[i - 1], &vars[i])) continue;
+    args__put(out, vars[i].name, vars[i].len);
+    args__put(out, "\n", 1);
+  }
+  ARGS_FREE(vars);
+}
+
+size_t args_ctx_complete_format(const args_ctx_t *ctx, const char *line, size_t point, char *buf, size_t cap) {
+  args__out_t out = {buf, cap ? cap - 1 : 0, 0, 0, false};
+  args__complete(ctx, line, point, &out);
+  if (cap) buf[out.len] = '\0';
+  return out.total;
+}
+
+#ifdef ARGS__ENVIRON
+// Value of environment variable `name`, or NULL.
+static const char *args__env(const char *name) {
+  size_t len = strlen(name);
+  char **env = ARGS__ENVIRON;
+  for (size_t i = 0; env && env[i]; ++i)
+    if (!strncmp(env[i], name, len) && env[i][len] == '=') return env[i] + len + 1;
+  return NULL;
+}
+#endif // ARGS__ENVIRON
+
+bool args_ctx_complete(const args_ctx_t *ctx) {
+#ifndef ARGS__ENVIRON
+  (void)ctx, (void)args__complete;
+  return false;
+#else
+  const char *line = args__env("COMP_LINE"), *point = args__env("COMP_POINT");
+  if (!line) return false;
+  uint64_t at = UINT64_MAX;
+  if (point && args__parse_u64(point, strlen(point), &at)) at = UINT64_MAX;
+  char buf[ARGS_PRINT_BUFFER];
+  args__out_t out = {buf, sizeof(buf), 0, 0, true};
+  args__complete(ctx, line, at > SIZE_MAX ? SIZE_MAX : (size_t)at, &out);
+  if (out.len) args__write(buf, out.len);
+  return true;
+#endif // ARGS__ENVIRON
+}
+
+// Readers of the default context are counted per epoch parity, in shards to keep threads off each others cache lines
+#define ARGS__READER_SHARDS 16
+
+static struct {
+  size_t count[2];
+  char pad[64 - 2 * sizeof(size_t)];
+} args__readers[ARGS__READER_SHARDS];
+static unsigned args__epoch;
+static bool args__reloading;
+
+// Start reading `args__current`, returns shard and parity to pass to `args__read_end()`.
+static unsigned args__read_begin(void) {
+  char here;
+  // Threads have distinct stacks, so the address of a local picks a shard per thread
+  unsigned shard = (unsigned)(((uintptr_t)&here >> 12) * 0x9E3779B9u) >> 28;
+  unsigned parity = __atomic_load_n(&args__epoch, __ATOMIC_SEQ_CST) & 1;
+  __atomic_fetch_add(&args__readers[shard].count[parity], 1, __ATOMIC_SEQ_CST);
+  return shard << 1 | parity;
+}
+
+static void args__read_end(unsigned reader) {
+  __atomic_fetch_sub(&args__readers[reader >> 1].count[reader & 1], 1, __ATOMIC_RELEASE);
+}
+
+static args_ctx_t *args__default(void) { return &__atomic_load_n(&args__current, __ATOMIC_SEQ_CST)->ctx; }
+
+// Call of an access function on the default context, which can't be freed by `args_reload()` meanwhile
+#define ARGS__READ(type, call)                                                                                         \
+  {                                                                                                                    \
+    unsigned reader = args__read_begin();                                                                              \
+    const args_ctx_t *ctx = args__default();                                                                           \
+    type result = call;                                                                                                \
+    args__read_end(reader);                                                                                            \
+    return result;                                                                                                     \
+  }
+
+static void args__yield(void) {
+#ifdef ARGS__MMAP
+  sched_yield();
+#endif // ARGS__MMAP
+}
+
+// Wait until readers that could see the previous `args__current` are done.
+// Flipping the epoch twice also waits for readers that loaded the epoch before the previous flip.
+static void args__synchronize(void) {
+  for (int flip = 0; flip < 2; ++flip) {
+    unsigned parity = __atomic_fetch_add(&args__epoch, 1, __ATOMIC_SEQ_CST) & 1;
+    for (size_t i = 0; i < ARGS__READER_SHARDS; ++i)
+      while (__atomic_load_n(&args__readers[i].count[parity], __ATOMIC_SEQ_CST)) args__yield();
+  }
+}
+
+static void args__snapshot_release(args__snapshot_t *snap) {
+  if (__atomic_fetch_sub(&snap->refs, 1, __ATOMIC_ACQ_REL)) return;
+  args_ctx_free(&snap->ctx);
+  if (snap->heap) ARGS_FREE(snap);
+}
+
+// Make the static snapshot current again, freeing a reloaded one.
+static void args__reset(void) {
+  args__snapshot_t *snap = args__current;
+  args__current = &args__static;
+  if (snap != &args__static) {
+    args_ctx_free(&snap->ctx);
+    if (snap->heap) ARGS_FREE(snap);
+  }
+  args_ctx_free(&args__static.ctx);
+  args__static.refs = 0;
+  memset(&args__opts, 0, sizeof(args__opts));
+}
+
+void args_parse(int argc, char **argv) {
+  args__reset();
+  args_ctx_init(&args__static.ctx, argc, argv);
+}
+
+int args_subcommand(int argc, char **argv, const char *const *commands, size_t ncommands) {
+  args__reset();
+  return args_ctx_subcommand(&args__static.ctx, argc, argv, commands, ncommands);
+}
+
+size_t args_parse_arena(int argc, char **argv, void *buf, size_t cap) {
+  args__reset();
+  return args_ctx_init_arena(&args__static.ctx, argc, argv, buf, cap);
+}
+
+args_err_t args_parse_opts(int argc, char **argv, const args_parse_opts_t *opts) {
+  args__reset();
+  if (opts) args__opts = *opts;
+  return args_ctx_init_opts(&args__static.ctx, argc, argv, opts);
+}
+
+void args_free() { args__reset(); }
+
+const args_ctx_t *args_default_ctx() { return args__default(); }
+
+bool args_reload(int argc, char **argv, args_setup_t setup, void *data) {
+  return args_reload_arena(argc, argv, NULL, 0, setup, data);
+}
+
+bool args_reload_arena(int argc, char **argv, void *buf, size_t cap, args_setup_t setup, void *data) {
+  args__snapshot_t *snap;
+  // Snapshot itself takes the start of the arena
+  size_t head = (ARGS__ALIGN - (uintptr_t)buf % ARGS__ALIGN) % ARGS__ALIGN + args__align(sizeof(args__snapshot_t));
+  if (buf) {
+    if (cap < head) return false;
+    snap = (args__snapshot_t *)((unsigned char *)buf + head - args__align(sizeof(args__snapshot_t)));
+  } else if (!(snap = (args__snapshot_t *)ARGS_MALLOC(sizeof(args__snapshot_t)))) {
+    return false;
+  }
+  args_err_t err;
+  size_t size = args__init(&snap->ctx, argc, argv, buf ? (unsigned char *)buf + head : NULL, buf ? cap - head : 0,
+                           &args__opts, &err);
+  snap->refs = 0;
+  snap->heap = !buf;
+  if (err || (buf && size > cap - head)) {
+    args_ctx_free(&snap->ctx);
+    if (snap->heap) ARGS_FREE(snap);
+    return false;
+  }
+  if (setup) setup(&snap->ctx, data);
+  // Reloads are serialized, readers are not affected
+  while (__atomic_test_and_set(&args__reloading, __ATOMIC_ACQUIRE)) args__yield();
+  args__snapshot_t *old = __atomic_exchange_n(&args__current, snap, __ATOMIC_SEQ_CST);
+  args__synchronize();
+  __atomic_clear(&args__reloading, __ATOMIC_RELEASE);
+  args__snapshot_release(old);
+  return true;
+}
+
+const args_ctx_t *args_acquire() {
+  unsigned reader = args__read_begin();
+  args__snapshot_t *snap = __atomic_load_n(&args__current, __ATOMIC_SEQ_CST);
+  __atomic_fetch_add(&snap->refs, 1, __ATOMIC_RELAXED);
+  args__read_end(reader);
+  return &snap->ctx;
+}
+
+void args_release(const args_ctx_t *ctx) { args__snapshot_release((args__snapshot_t *)ctx); }
+
+const args_ctx_t *args_read_begin(unsigned *reader) {
+  *reader = args__read_begin();
+  return args__default();
+}
+
+void args_read_end(unsigned reader) { args__read_end(reader); }
+
+args_err_t args_parse_into(const args_spec_t *spec, size_t nspec, void *out) {
+  ARGS__READ(args_err_t, args_ctx_parse_into(ctx, spec, nspec, out))
+}
+
+const char *const *args_unknown(size_t *count) { ARGS__READ(const char *const *, args_ctx_unknown(ctx, count)) }
+
+const char *const *args_positional(size_t *count) {
+  ARGS__READ(const char *const *, args_ctx_positional(ctx, count))
+}
+
+bool args_parse_env(const char *prefix) { return args_ctx_parse_env(args__default(), prefix); }
+
+bool args_load_file(const char *path) { return args_ctx_load_file(args__default(), path); }
+
+size_t args_serialize(void *buf, size_t cap) { ARGS__READ(size_t, args_ctx_serialize(ctx, buf, cap)) }
+
+bool args_attach(const void *buf, size_t size) {
+  args__reset();
+  return args_ctx_attach(&args__static.ctx, buf, size);
+}
+
+int args_register(const char *arg) { return args_ctx_register(args__default(), arg); }
+
+bool args_freeze() { return args_ctx_freeze(args__default()); }
+
+int args_classify(const char *token) { ARGS__READ(int, args_ctx_classify(ctx, token)) }
+
+int args_resolve(const char *token) { ARGS__READ(int, args_ctx_resolve(ctx, token)) }
+
+size_t args_abbreviate() { return args_ctx_abbreviate(args__default()); }
+
+args_string_view_t args_suggest(const char *token) { ARGS__READ(args_string_view_t, args_ctx_suggest(ctx, token)) }
+
+bool args_complete() { ARGS__READ(bool, args_ctx_complete(ctx)) }
+
+void args_print() {
+  unsigned reader = args__read_begin();
+  args_ctx_print(args__default());
+  args__read_end(reader);
+}
+
+size_t args_format(char *buf, size_t cap) { ARGS__READ(size_t, args_ctx_format(ctx, buf, cap)) }
+
+#ifdef ARGS_STATS
+static int args__compare_key_stats(const void *a, const void *b) {
+  const args_key_stats_t *x = (const args_key_stats_t *)a, *y = (const args_key_stats_t *)b;
+  return x->lookups != y->lookups ? (x->lookups < y->lookups ? 1 : -1) : 0;
+}
+#endif // ARGS_STATS
+
+args_stats_t args_stats() {
+  args_stats_t stats;
+  memset(&stats, 0, sizeof(stats));
+#ifdef ARGS_STATS
+  stats.lookups = ARGS__LOAD(&args__stats.lookups);
+  stats.misses = ARGS__LOAD(&args__stats.misses);
+  stats.scanned = ARGS__LOAD(&args__stats.scanned);
+  stats.compares = ARGS__LOAD(&args__stats.compares);
+  stats.cache_hits = ARGS__LOAD(&args__stats.cache_hits);
+  stats.nanoseconds = ARGS__LOAD(&args__stats.nanoseconds);
+  for (size_t i = 0; i < ARGS_STATS_KEYS; ++i) {
+    const char *arg = ARGS__LOAD(&args__stats.keys[i].arg);
+    if (!arg) continue;
+    args_key_stats_t *key = &stats.keys[stats.nkeys++];
+    key->arg = arg;
+    key->lookups = ARGS__LOAD(&args__stats.keys[i].lookups);
+    key->nanoseconds = ARGS__LOAD(&args__stats.keys[i].nanoseconds);
+  }
+  args__sort(stats.keys, stats.nkeys, sizeof(args_key_stats_t), args__compare_key_stats);
+#endif // ARGS_STATS
+  return stats;
+}
+
+void args_stats_reset() {
+#ifdef ARGS_STATS
+  // Not atomic as a whole, lookups running at the same time may be partially counted
+  memset(&args__stats, 0, sizeof(args__stats));
+#endif // ARGS_STATS
+}
+
+void args_stats_print() {
+  args_stats_t stats = args_stats();
+  char buf[ARGS_PRINT_BUFFER];
+  args__out_t out = {buf, sizeof(buf), 0, 0, true};
+  const char *names[] = {"Lookups: ", " (", " missing), scanned: ", ", compares: ", ", cache hits: ", ", time: "};
+  uint64_t values[] = {stats.lookups, stats.misses, stats.scanned, stats.compares, stats.cache_hits, stats.nanoseconds};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    args__put_str(&out, names[i]);
+    args__put_uint(&out, values[i], 0);
+  }
+  args__put_str(&out, " ns\n");
+  for (size_t i = 0; i < stats.nkeys; ++i) {
+    args__put_str(&out, "  ");
+    args__put_uint(&out, stats.keys[i].lookups, 10);
+    args__put_str(&out, " lookups ");
+    args__put_uint(&out, stats.keys[i].nanoseconds, 12);
+    args__put_str(&out, " ns  ");
+    args__put_str(&out, stats.keys[i].arg);
+    args__put(&out, "\n", 1);
+  }
+  if (out.len) args__write(buf, out.len);
+}
+
+bool args_bool(const char *arg) { ARGS__READ(bool, args_ctx_bool(ctx, arg)) }
+
+int args_int(const char *arg) { ARGS__READ(int, args_ctx_int(ctx, arg)) }
+
+int64_t args_int64(const char *arg) { ARGS__READ(int64_t, args_ctx_int64(ctx, arg)) }
+
+uint64_t args_uint64(const char *arg) { ARGS__READ(uint64_t, args_ctx_uint64(ctx, arg)) }
+
+size_t args_size(const char *arg) { ARGS__READ(size_t, args_ctx_size(ctx, arg)) }
+
+args_err_t args_int_ex(const char *arg, int *out) { ARGS__READ(args_err_t, args_ctx_int_ex(ctx, arg, out)) }
+
+args_err_t args_int64_ex(const char *arg, int64_t *out) { ARGS__READ(args_err_t, args_ctx_int64_ex(ctx, arg, out)) }
+
+args_err_t args_uint64_ex(const char *arg, uint64_t *out) {
+  ARGS__READ(args_err_t, args_ctx_uint64_ex(ctx, arg, out))
+}
+
+args_err_t args_size_ex(const char *arg, size_t *out) { ARGS__READ(args_err_t, args_ctx_size_ex(ctx, arg, out)) }
+
+uint64_t args_bytes(const char *arg) { ARGS__READ(uint64_t, args_ctx_bytes(ctx, arg)) }
+
+uint64_t args_duration_ns(const char *arg) { ARGS__READ(uint64_t, args_ctx_duration_ns(ctx, arg)) }
+
+args_err_t args_bytes_ex(const char *arg, uint64_t *out) { ARGS__READ(args_err_t, args_ctx_bytes_ex(ctx, arg, out)) }
+
+args_err_t args_duration_ns_ex(const char *arg, uint64_t *out) {
+  ARGS__READ(args_err_t, args_ctx_duration_ns_ex(ctx, arg, out))
+}
+
+double args_float(const char *arg) { ARGS__READ(double, args_ctx_float(ctx, arg)) }
+
+args_err_t args_float_ex(const char *arg, double *out) { ARGS__READ(args_err_t, args_ctx_float_ex(ctx, arg, out)) }
+
+const char *args_string(const char *arg) { ARGS__READ(const char *, args_ctx_string(ctx, arg)) }
+
+args_string_view_t args_string_view(const char *arg) {
+  ARGS__READ(args_string_view_t, args_ctx_string_view(ctx, arg))
+}
+
+int args_choice(const char *arg, const char *const *choices, size_t n) {
+  ARGS__READ(int, args_ctx_choice(ctx, arg, choices, n))
+}
+
+args_err_t args_choice_ex(const char *arg, const char *const *choices, size_t n, int *out) {
+  ARGS__READ(args_err_t, args_ctx_choice_ex(ctx, arg, choices, n, out))
+}
+
+const int64_t *args_int_list(const char *arg, size_t *count) {
+  ARGS__READ(const int64_t *, args_ctx_int_list(ctx, arg, count))
+}
+
+const double *args_float_list(const char *arg, size_t *count) {
+  ARGS__READ(const double *, args_ctx_float_list(ctx, arg, count))
+}
+
+const args_string_view_t *args_string_list(const char *arg, size_t *count) {
+  ARGS__READ(const args_string_view_t *, args_ctx_string_list(ctx, arg, count))
 }
 
 #endif // ARGS_IMPLEMENTATION
@@ -0,0 +1,166 @@
+/*
+
+LICENSE:
+
+    SPDX-License-Identifier: Zlib
+
+    Copyright (c) 2025 Vlad Krupinskii <mrvladus@yandex.ru>
+
+    This software is provided 'as-is', without any express or implied
+    warranty. In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter it and redistribute it
+    freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+    3. This notice may not be removed or altered from any source distribution.
+
+DESCRIPTION:
+
+    args.hpp is an optional C++17 layer on top of args.h.
+    Argument specs like "-p|--port" are split and hashed at compile time,
+    so a lookup at runtime is a single probe per variant into the index built by `args_parse()`.
+    Nothing is allocated and nothing throws.
+
+USAGE:
+
+    // Define ARGS_IMPLEMENTATION in ONE file, same as for args.h.
+    #define ARGS_IMPLEMENTATION
+    #include "args.hpp"
+
+    int main(int argc, char **argv) {
+      args_parse(argc, argv);
+
+      int port = args::get<int>(ARGS_KEY("-p|--port"));
+      bool verbose = args::get<bool>(ARGS_KEY("-v|--verbose"));
+      args_string_view_t name = args::get<args_string_view_t>(ARGS_KEY("--name"));
+
+      // Tell a missing argument from zero or an empty string
+      std::optional<double> ratio = args::find<double>(ARGS_KEY("--ratio"));
+      std::optional<std::string_view> user = args::find<std::string_view>(ARGS_KEY("-u|--user"));
+
+      return 0;
+    }
+
+*/
+
+#ifndef ARGS_HPP
+#define ARGS_HPP
+
+#include "args.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace args {
+
+// Compile-time `args_hash()`.
+constexpr uint32_t hash(const char *s, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i) h = (h ^ (unsigned char)s[i]) * 16777619u;
+  return h;
+}
+
+// Argument spec split into precomputed variants.
+template <size_t N> struct key {
+  args_key_t keys[N ? N : 1];
+  size_t count;
+};
+
+namespace detail {
+
+// Number of non-empty "|" separated variants in `spec`.
+constexpr size_t count(const char *spec) {
+  size_t n = 0;
+  for (size_t i = 0; spec[i]; ++i)
+    if (spec[i] != '|' && (i == 0 || spec[i - 1] == '|')) n++;
+  return n;
+}
+
+template <size_t N> constexpr key<N> split(const char *spec) {
+  key<N> result{};
+  size_t i = 0;
+  while (spec[i]) {
+    while (spec[i] == '|') i++;
+    if (!spec[i]) break;
+    size_t start = i;
+    while (spec[i] && spec[i] != '|') i++;
+    result.keys[result.count++] = args_key_t{spec + start, i - start, hash(spec + start, i - start)};
+  }
+  return result;
+}
+
+} // namespace detail
+
+// Get value of argument from `ctx`, converted to `T`.
+// `T` is one of: bool, signed and unsigned integer types, float, double, std::string_view, args_string_view_t.
+// Returns `std::nullopt` if argument is missing, malformed or out of range of `T`.
+// Numbers are parsed by args.h, so they are accepted in the same formats as by the C functions.
+template <typename T, size_t N> std::optional<T> find(const key<N> &k, const args_ctx_t *ctx) noexcept {
+  if constexpr (std::is_same_v<T, bool>) {
+    bool value = false;
+    if (args_ctx_bool_keys_ex(ctx, k.keys, k.count, &value) != ARGS_OK) return std::nullopt;
+    return value;
+  } else if constexpr (std::is_same_v<T, args_string_view_t> || std::is_same_v<T, std::string_view>) {
+    args_string_view_t value{};
+    if (args_ctx_string_view_keys_ex(ctx, k.keys, k.count, &value) != ARGS_OK) return std::nullopt;
+    if constexpr (std::is_same_v<T, std::string_view>) return std::string_view(value.ptr, value.len);
+    else return value;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    double value = 0;
+    if (args_ctx_float_keys(ctx, k.keys, k.count, &value) != ARGS_OK) return std::nullopt;
+    return (T)value;
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    int64_t value = 0;
+    if (args_ctx_int64_keys(ctx, k.keys, k.count, &value) != ARGS_OK) return std::nullopt;
+    if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) return std::nullopt;
+    return (T)value;
+  } else if constexpr (std::is_integral_v<T>) {
+    uint64_t value = 0;
+    if (args_ctx_uint64_keys(ctx, k.keys, k.count, &value) != ARGS_OK) return std::nullopt;
+    if (value > std::numeric_limits<T>::max()) return std::nullopt;
+    return (T)value;
+  } else {
+    static_assert(!sizeof(T), "unsupported argument type");
+  }
+}
+
+// Same as above, but reads the default context under the per-thread read guard of the C access functions,
+// so concurrent readers don't contend. String views stay valid as long as those of `args_string_view()`.
+template <typename T, size_t N> std::optional<T> find(const key<N> &k) noexcept {
+  unsigned reader;
+  const args_ctx_t *ctx = args_read_begin(&reader);
+  std::optional<T> value = find<T>(k, ctx);
+  args_read_end(reader);
+  return value;
+}
+
+// Same as `find()`, but returns zero value instead of `std::nullopt`, like the C functions.
+template <typename T, size_t N> T get(const key<N> &k, const args_ctx_t *ctx) noexcept {
+  return find<T>(k, ctx).value_or(T{});
+}
+
+// Same as above, but reads the default context.
+template <typename T, size_t N> T get(const key<N> &k) noexcept { return find<T>(k).value_or(T{}); }
+
+} // namespace args
+
+// Split and hash argument spec string literal at compile time.
+#define ARGS_KEY(spec)                                                                                                 \
+  ([] {                                                                                                                \
+    constexpr auto key = ::args::detail::split<::args::detail::count(spec)>(spec);                                     \
+    return key;                                                                                                        \
+  }())
+
+#endif // ARGS_HPP
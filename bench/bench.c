@@ -0,0 +1,260 @@
+// make bench
+// ./bench/bench [--quick] [--max-argc <n>] [--runs <n>] > bench.json
+//
+// Measures parse time, lookup latency and cold process startup of args.h and prints results as JSON.
+// Lookups are compared against `scan`, a reference of the old accessors that rescan argv for every alias.
+
+#define ARGS_IMPLEMENTATION
+#include "../args.h"
+
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+typedef enum {
+  BENCH_BOOL,
+  BENCH_INT,
+  BENCH_FLOAT,
+  BENCH_STRING,
+} bench_type_t;
+
+static const char *bench_type_names[] = {"bool", "int", "float", "string"};
+
+// Number of distinct argument specs queried in a loop
+#define BENCH_SPECS 1024
+
+static volatile double bench_sink;
+static bool bench_first = true;
+
+static double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench_result(const char *name, const char *impl, size_t argc, int aliases, const char *type,
+                         double hit_ratio, size_t ops, double ns) {
+  printf("%s\n    {\"name\": \"%s\", \"impl\": \"%s\", \"argc\": %zu, \"aliases\": %d, \"type\": \"%s\", "
+         "\"hit_ratio\": %.2f, \"ops\": %zu, \"ns_per_op\": %.2f}",
+         bench_first ? "" : ",", name, impl, argc, aliases, type, hit_ratio, ops, ns / ops);
+  bench_first = false;
+  fflush(stdout);
+}
+
+// Token `i` is `--<type><i>=<value>`, types alternate.
+static char **bench_make_argv(size_t n) {
+  static const char *values[] = {"true", "1234567", "3.25", "value"};
+  char **argv = (char **)malloc((n + 2) * sizeof(char *));
+  argv[0] = (char *)"bench";
+  for (size_t i = 0; i < n; ++i) {
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "--%s%zu=%s", bench_type_names[i % 4], i, values[i % 4]);
+    argv[i + 1] = (char *)malloc(len + 1);
+    memcpy(argv[i + 1], buf, len + 1);
+  }
+  argv[n + 1] = NULL;
+  return argv;
+}
+
+static void bench_free_argv(char **argv, size_t n) {
+  for (size_t i = 0; i < n; ++i) free(argv[i + 1]);
+  free(argv);
+}
+
+// Specs with `aliases` variants of which only the last one can be present.
+// `hit_ratio` of them name an existing argument of `type`.
+static char **bench_make_specs(size_t n, int aliases, bench_type_t type, double hit_ratio) {
+  char **specs = (char **)malloc(BENCH_SPECS * sizeof(char *));
+  for (size_t i = 0; i < BENCH_SPECS; ++i) {
+    char buf[256];
+    int len = 0;
+    for (int a = 1; a < aliases; ++a) len += snprintf(buf + len, sizeof(buf) - len, "-a%d_%zu|", a, i);
+    // Spread hits evenly over the spec array and over argv
+    bool hit = n >= 4 && (size_t)((i + 1) * hit_ratio) != (size_t)(i * hit_ratio);
+    size_t index = (i * 7919 % (n / 4 ? n / 4 : 1)) * 4 + type;
+    if (hit) snprintf(buf + len, sizeof(buf) - len, "--%s%zu", bench_type_names[type], index);
+    else snprintf(buf + len, sizeof(buf) - len, "--missing%zu", i);
+    specs[i] = strdup(buf);
+  }
+  return specs;
+}
+
+static void bench_free_specs(char **specs) {
+  for (size_t i = 0; i < BENCH_SPECS; ++i) free(specs[i]);
+  free(specs);
+}
+
+// Reference lookup: rescan argv for every variant, the last occurrence wins.
+static const char *bench_scan(int argc, char **argv, const char *spec) {
+  const char *found = NULL;
+  int found_at = -1;
+  while (*spec) {
+    const char *end = strchr(spec, '|');
+    size_t len = end ? (size_t)(end - spec) : strlen(spec);
+    for (int i = 1; i < argc; ++i) {
+      if (i > found_at && !strncmp(argv[i], spec, len) && (argv[i][len] == '=' || argv[i][len] == '\0')) {
+        found_at = i;
+        found = argv[i][len] == '=' ? argv[i] + len + 1 : (i + 1 < argc ? argv[i + 1] : "");
+      }
+    }
+    if (!end) break;
+    spec = end + 1;
+  }
+  return found;
+}
+
+static double bench_lookup_indexed(const args_ctx_t *ctx, char **specs, bench_type_t type, size_t ops) {
+  double sum = 0, start = bench_now();
+  for (size_t i = 0; i < ops; ++i) {
+    const char *spec = specs[i % BENCH_SPECS];
+    switch (type) {
+    case BENCH_BOOL: sum += args_ctx_bool(ctx, spec); break;
+    case BENCH_INT: sum += args_ctx_int(ctx, spec); break;
+    case BENCH_FLOAT: sum += args_ctx_float(ctx, spec); break;
+    case BENCH_STRING: sum += args_ctx_string_view(ctx, spec).len; break;
+    }
+  }
+  double ns = bench_now() - start;
+  bench_sink = sum;
+  return ns;
+}
+
+static double bench_lookup_scan(int argc, char **argv, char **specs, bench_type_t type, size_t ops) {
+  double sum = 0, start = bench_now();
+  for (size_t i = 0; i < ops; ++i) {
+    const char *value = bench_scan(argc, argv, specs[i % BENCH_SPECS]);
+    if (!value) continue;
+    switch (type) {
+    case BENCH_BOOL: sum += !strcmp(value, "") || !strcmp(value, "true"); break;
+    case BENCH_INT: sum += atoi(value); break;
+    case BENCH_FLOAT: sum += atof(value); break;
+    case BENCH_STRING: sum += strlen(value); break;
+    }
+  }
+  double ns = bench_now() - start;
+  bench_sink = sum;
+  return ns;
+}
+
+// Best of `runs`
+static double bench_parse(int argc, char **argv, int runs) {
+  double best = 0;
+  for (int r = 0; r < runs; ++r) {
+    args_ctx_t ctx;
+    double start = bench_now();
+    args_ctx_init(&ctx, argc, argv);
+    double ns = bench_now() - start;
+    args_ctx_free(&ctx);
+    if (!r || ns < best) best = ns;
+  }
+  return best;
+}
+
+// Spawn `bench --child` with `n` generated arguments, passed through a response file when there are many.
+static double bench_spawn(const char *self, size_t n, int runs) {
+  char **argv = bench_make_argv(n);
+  char path[] = "/tmp/args-bench-XXXXXX";
+  char rsp[sizeof(path) + 1];
+  char *child[5] = {(char *)self, (char *)"--child", NULL, NULL, NULL};
+  int fd = -1;
+  if (n > 1000) {
+    fd = mkstemp(path);
+    FILE *file = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!file) {
+      bench_free_argv(argv, n);
+      return -1;
+    }
+    for (size_t i = 0; i < n; ++i) fprintf(file, "%s\n", argv[i + 1]);
+    fclose(file);
+    snprintf(rsp, sizeof(rsp), "@%s", path);
+    child[2] = rsp;
+  }
+  // Inline arguments follow `--child`
+  char **spawn_argv = child;
+  if (fd < 0) {
+    spawn_argv = (char **)malloc((n + 3) * sizeof(char *));
+    spawn_argv[0] = (char *)self;
+    spawn_argv[1] = (char *)"--child";
+    for (size_t i = 0; i < n; ++i) spawn_argv[i + 2] = argv[i + 1];
+    spawn_argv[n + 2] = NULL;
+  }
+  double best = -1;
+  for (int r = 0; r < runs; ++r) {
+    pid_t pid;
+    int status;
+    double start = bench_now();
+    if (posix_spawn(&pid, self, NULL, NULL, spawn_argv, environ)) break;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) break;
+    double ns = bench_now() - start;
+    if (best < 0 || ns < best) best = ns;
+  }
+  if (fd >= 0) unlink(path);
+  else free(spawn_argv);
+  bench_free_argv(argv, n);
+  return best;
+}
+
+int main(int argc, char **argv) {
+  args_parse(argc, argv);
+
+  // Cold startup: parse everything and read one argument
+  if (args_bool("--child")) {
+    bench_sink = args_int("--int1");
+    return 0;
+  }
+
+  bool quick = args_bool("--quick");
+  size_t max_argc = args_size("--max-argc");
+  int runs = args_int("--runs");
+  if (!max_argc) max_argc = quick ? 10000 : 1000000;
+  if (runs <= 0) runs = quick ? 3 : 10;
+
+  static const int aliases[] = {1, 3};
+  static const double hit_ratios[] = {0, 0.5, 1};
+  // Total work of a lookup series
+  const double budget = quick ? 2e6 : 2e7;
+
+  printf("{\n  \"bench\": \"args.h\",\n  \"quick\": %s,\n  \"results\": [", quick ? "true" : "false");
+  for (size_t n = 10; n <= max_argc; n *= 10) {
+    char **bench_argv = bench_make_argv(n);
+    bench_result("parse", "indexed", n, 0, "", 0, 1, bench_parse((int)n + 1, bench_argv, runs));
+
+    args_ctx_t ctx;
+    args_ctx_init(&ctx, (int)n + 1, bench_argv);
+    for (size_t a = 0; a < sizeof(aliases) / sizeof(*aliases); ++a) {
+      for (int type = BENCH_BOOL; type <= BENCH_STRING; ++type) {
+        for (size_t h = 0; h < sizeof(hit_ratios) / sizeof(*hit_ratios); ++h) {
+          char **specs = bench_make_specs(n, aliases[a], (bench_type_t)type, hit_ratios[h]);
+          size_t ops = (size_t)(budget / 10);
+          double ns = bench_lookup_indexed(&ctx, specs, (bench_type_t)type, ops);
+          bench_result("lookup", "indexed", n, aliases[a], bench_type_names[type], hit_ratios[h], ops, ns);
+          // Scan is linear in argc, keep its total work bounded
+          ops = (size_t)(budget / (n * aliases[a]));
+          if (ops >= 100) {
+            ns = bench_lookup_scan((int)n + 1, bench_argv, specs, (bench_type_t)type, ops);
+            bench_result("lookup", "scan", n, aliases[a], bench_type_names[type], hit_ratios[h], ops, ns);
+          }
+          bench_free_specs(specs);
+        }
+      }
+    }
+    args_ctx_free(&ctx);
+    bench_free_argv(bench_argv, n);
+  }
+
+  // Process startup, `argc` 0 is the cost of spawning alone
+  for (size_t n = 0; n <= max_argc; n = n ? n * 10 : 10) {
+    double ns = bench_spawn(argv[0], n, runs);
+    if (ns >= 0) bench_result("startup", "indexed", n, 0, "", 0, 1, ns);
+  }
+  printf("\n  ]\n}\n");
+
+  args_free();
+  return 0;
+}
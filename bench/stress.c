@@ -0,0 +1,238 @@
+// make stress
+// ./bench/stress [--quick]
+//
+// Checks that parsing and lookups stay linear on adversarial command lines and prints results as JSON:
+// - keys that all have the same FNV-1a hash, parsed with a random seed and, for small counts, without one
+// - one key repeated many times, whose later lookups must not walk its occurrences again
+// - a spec with thousands of `|` variants
+// - limits of `args_parse_opts_t`, which must give up without looking at the whole command line
+// Exits with 1 if time per token or per lookup grows more than `STRESS_SLACK` times between the smallest and
+// the largest run.
+
+#define ARGS_IMPLEMENTATION
+#include "../args.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Allowed growth of time per token, for cache misses of larger inputs
+#define STRESS_SLACK 4.0
+
+// Colliding blocks are 6 lowercase letters
+#define STRESS_BLOCK 6
+
+static volatile size_t stress_sink;
+static bool stress_first = true;
+static bool stress_failed = false;
+
+static double stress_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void stress_result(const char *name, const char *mode, size_t n, double ns) {
+  printf("%s\n    {\"name\": \"%s\", \"mode\": \"%s\", \"n\": %zu, \"ns_per_item\": %.2f}", stress_first ? "" : ",", name,
+         mode, n, ns / n);
+  stress_first = false;
+  fflush(stdout);
+}
+
+static uint32_t stress_step(uint32_t h, const char *s, size_t len) {
+  for (size_t i = 0; i < len; ++i) h = (h ^ (unsigned char)s[i]) * 16777619u;
+  return h;
+}
+
+// Block number `i`, letters are scrambled because FNV-1a of similar short strings hardly ever collides
+static void stress_block(uint32_t i, char *out) {
+  uint64_t x = i * 0x9E3779B97F4A7C15ull;
+  x ^= x >> 29;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 32;
+  for (int k = 0; k < STRESS_BLOCK; ++k) out[k] = (char)('a' + (x >> (5 * k)) % 26);
+}
+
+// Find two different blocks that take FNV-1a state `h` to the same state, by the birthday bound.
+static bool stress_collide(uint32_t h, char *a, char *b, uint32_t *next) {
+  enum { BITS = 20 };
+  static uint32_t seen[1u << BITS][2];
+  memset(seen, 0, sizeof(seen));
+  // Table stays half empty, a collision is expected after about 2^17 blocks
+  for (uint32_t i = 1; i < (1u << (BITS - 1)); ++i) {
+    char block[STRESS_BLOCK];
+    stress_block(i, block);
+    uint32_t v = stress_step(h, block, STRESS_BLOCK);
+    for (uint32_t j = v >> (32 - BITS);; j = (j + 1) & ((1u << BITS) - 1)) {
+      if (!seen[j][1]) {
+        seen[j][0] = v;
+        seen[j][1] = i;
+        break;
+      }
+      if (seen[j][0] == v) {
+        stress_block(seen[j][1], a);
+        if (!memcmp(a, block, STRESS_BLOCK)) break;
+        memcpy(b, block, STRESS_BLOCK);
+        *next = v;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// `2^k` distinct arguments `--<key>=1` whose keys have equal FNV-1a hashes: key `i` picks block `a` or `b`
+// of pair `j` by bit `j` of `i`, and every pair takes the hash to the same state.
+static char **stress_make_argv(int k, char pairs[][2][STRESS_BLOCK]) {
+  size_t n = (size_t)1 << k, len = 2 + (size_t)k * STRESS_BLOCK + 3;
+  char **argv = (char **)malloc((n + 2) * sizeof(char *));
+  char *text = (char *)malloc(n * len);
+  argv[0] = (char *)"stress";
+  for (size_t i = 0; i < n; ++i) {
+    char *arg = argv[i + 1] = text + i * len;
+    memcpy(arg, "--", 2);
+    for (int j = 0; j < k; ++j) memcpy(arg + 2 + j * STRESS_BLOCK, pairs[j][(i >> j) & 1], STRESS_BLOCK);
+    memcpy(arg + len - 3, "=1", 3);
+  }
+  argv[n + 1] = NULL;
+  return argv;
+}
+
+static void stress_free_argv(char **argv) {
+  free(argv[1]);
+  free(argv);
+}
+
+// Parse and read every argument once, returns total time.
+static double stress_parse(size_t n, char **argv, uint32_t seed) {
+  double start = stress_now();
+  args_ctx_t ctx;
+  args_parse_opts_t opts = {.seed = seed};
+  args_ctx_init_opts(&ctx, (int)n + 1, argv, &opts);
+  size_t sum = 0;
+  char key[256];
+  for (size_t i = 0; i < n; ++i) {
+    size_t len = strlen(argv[i + 1]) - 2;
+    memcpy(key, argv[i + 1], len);
+    key[len] = '\0';
+    sum += args_ctx_int(&ctx, key);
+  }
+  double ns = stress_now() - start;
+  if (sum != n) stress_failed = true;
+  stress_sink = sum;
+  args_ctx_free(&ctx);
+  return ns;
+}
+
+// Parse `n` copies of `-v` and look it up `STRESS_LOOKUPS` times, returns time of the repeated lookups.
+// The first lookup marks all copies consumed and is counted with parsing in `*parse_ns`.
+#define STRESS_LOOKUPS 10000
+static double stress_repeat(size_t n, uint32_t seed, double *parse_ns) {
+  char **argv = (char **)malloc((n + 2) * sizeof(char *));
+  argv[0] = (char *)"stress";
+  for (size_t i = 1; i <= n; ++i) argv[i] = (char *)"-v";
+  argv[n + 1] = NULL;
+  double start = stress_now();
+  args_ctx_t ctx;
+  args_parse_opts_t opts = {.seed = seed};
+  args_ctx_init_opts(&ctx, (int)n + 1, argv, &opts);
+  size_t sum = args_ctx_bool(&ctx, "-v");
+  *parse_ns = stress_now() - start;
+  start = stress_now();
+  for (size_t i = 0; i < STRESS_LOOKUPS; ++i) sum += args_ctx_bool(&ctx, "-v");
+  double ns = stress_now() - start;
+  if (sum != STRESS_LOOKUPS + 1) stress_failed = true;
+  stress_sink = sum;
+  args_ctx_free(&ctx);
+  free(argv);
+  return ns;
+}
+
+static void stress_check(const char *name, double first, double last) {
+  if (last > first * STRESS_SLACK) {
+    fprintf(stderr, "%s: %.2f ns per item grew to %.2f\n", name, first, last);
+    stress_failed = true;
+  }
+}
+
+int main(int argc, char **argv) {
+  args_parse(argc, argv);
+  bool quick = args_bool("--quick");
+  int max_k = quick ? 16 : 18, max_plain_k = quick ? 11 : 13;
+
+  // Collisions are chained from the state after `--`
+  static char pairs[32][2][STRESS_BLOCK];
+  uint32_t h = stress_step(2166136261u, "--", 2);
+  for (int j = 0; j < max_k; ++j)
+    if (!stress_collide(h, pairs[j][0], pairs[j][1], &h)) return 1;
+
+  printf("{\n  \"bench\": \"args.h stress\",\n  \"quick\": %s,\n  \"results\": [", quick ? "true" : "false");
+  uint32_t seed = (uint32_t)stress_now() | 1;
+  double first = 0, ns = 0;
+  for (int k = 10; k <= max_k; k += 2) {
+    size_t n = (size_t)1 << k;
+    char **stress_argv = stress_make_argv(k, pairs);
+    ns = stress_parse(n, stress_argv, seed) / n;
+    if (k == 10) first = ns;
+    stress_result("colliding_keys", "seeded", n, ns * n);
+    // Without a seed all keys share one probe sequence, so this grows quadratically
+    if (k <= max_plain_k) stress_result("colliding_keys", "plain", n, stress_parse(n, stress_argv, 0));
+    stress_free_argv(stress_argv);
+  }
+  stress_check("colliding_keys", first, ns);
+
+  // Later lookups of a repeated key don't depend on how often it is repeated
+  double first_parse = 0, parse = 0;
+  for (size_t n = 1024; n <= (quick ? 65536u : 1048576u); n *= 4) {
+    ns = stress_repeat(n, seed, &parse) / STRESS_LOOKUPS;
+    if (n == 1024) first = ns, first_parse = parse / n;
+    stress_result("repeated_key_parse", "seeded", n, parse);
+    stress_result("repeated_key_lookup", "seeded", STRESS_LOOKUPS, ns * STRESS_LOOKUPS);
+  }
+  stress_check("repeated_key_parse", first_parse, parse / (quick ? 65536u : 1048576u));
+  stress_check("repeated_key_lookup", first, ns);
+
+  // Lookup of a spec with many variants is one probe per variant
+  char *spec_argv[] = {(char *)"stress", (char *)"--v0=1", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, 2, spec_argv);
+  for (size_t n = 1024; n <= (quick ? 16384u : 262144u); n *= 4) {
+    char *spec = (char *)malloc(n * 16);
+    size_t len = 0;
+    for (size_t i = n; i-- > 0;) len += (size_t)sprintf(spec + len, "--v%zu|", i);
+    spec[len - 1] = '\0';
+    double start = stress_now();
+    stress_sink = (size_t)args_ctx_int(&ctx, spec);
+    ns = (stress_now() - start) / n;
+    if (n == 1024) first = ns;
+    stress_result("spec_variants", "plain", n, ns * n);
+    free(spec);
+  }
+  args_ctx_free(&ctx);
+  stress_check("spec_variants", first, ns);
+
+  // Limits: too many arguments is rejected from `argc`, an overlong one stops the scan at the limit
+  size_t n = quick ? 100000 : 1000000;
+  char **many = (char **)malloc((n + 2) * sizeof(char *));
+  char *huge = (char *)malloc(n * 64 + 1);
+  memset(huge, 'x', n * 64);
+  huge[n * 64] = '\0';
+  for (size_t i = 0; i <= n; ++i) many[i] = huge;
+  many[n + 1] = NULL;
+  args_parse_opts_t opts = {.max_tokens = 1000, .max_token_len = 4096, .seed = seed};
+  double start = stress_now();
+  args_err_t err = args_ctx_init_opts(&ctx, (int)n + 1, many, &opts);
+  stress_result("max_tokens", "rejected", n, stress_now() - start);
+  if (err != ARGS_ERR_RANGE) stress_failed = true;
+  start = stress_now();
+  err = args_ctx_init_opts(&ctx, 2, many, &opts);
+  stress_result("max_token_len", "rejected", n * 64, stress_now() - start);
+  if (err != ARGS_ERR_RANGE) stress_failed = true;
+  free(huge);
+  free(many);
+
+  printf("\n  ],\n  \"linear\": %s\n}\n", stress_failed ? "false" : "true");
+  args_free();
+  return stress_failed;
+}
@@ -0,0 +1,120 @@
+// make test
+// ./test/test-freestanding
+//
+// Behavior tests of args.h built with `ARGS_FREESTANDING`: no stdio, malloc, environment or files,
+// heap memory from a small static buffer, output through `ARGS_WRITE`.
+// Prints failed checks and exits with 1 if there are any.
+
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+// Output of `args_print()` is captured to be checked
+static char test_output[256];
+static size_t test_output_len;
+
+static void test_capture(const char *buf, size_t len) {
+  if (len > sizeof(test_output) - test_output_len) len = sizeof(test_output) - test_output_len;
+  memcpy(test_output + test_output_len, buf, len);
+  test_output_len += len;
+}
+
+#define ARGS_FREESTANDING
+#define ARGS_STATIC_HEAP_SIZE 8192
+#define ARGS_WRITE(buf, len) test_capture(buf, len)
+#define ARGS_IMPLEMENTATION
+#include "../args.h"
+
+static int test_failed;
+
+static void test_puts(const char *s) {
+  ssize_t written = write(2, s, strlen(s));
+  (void)written;
+}
+
+#define TEST_STR(x) #x
+#define TEST_LINE(x) TEST_STR(x)
+
+#define CHECK(cond)                                                                                                    \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      test_puts(__FILE__ ":" TEST_LINE(__LINE__) ": " #cond "\n");                                                     \
+      test_failed++;                                                                                                   \
+    }                                                                                                                  \
+  } while (0)
+
+#define TEST_ARGC(argv) ((int)(sizeof(argv) / sizeof(*(argv))) - 1)
+
+static void test_lookup(void) {
+  char *argv[] = {"test", "--port=8080", "--ratio", "0.5", "--name=\"John Smith\"", "--id=1,2,3", "@args.rsp", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_int(&ctx, "-p|--port") == 8080 && args_ctx_float(&ctx, "--ratio") == 0.5);
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.len == 10 && !memcmp(name.ptr, "John Smith", 10));
+  size_t n = 0;
+  const int64_t *ids = args_ctx_int_list(&ctx, "--id", &n);
+  CHECK(ids && n == 3 && ids[2] == 3);
+  // No files or environment, response files are plain arguments
+  const char *const *positional = args_ctx_positional(&ctx, &n);
+  CHECK(positional && n == 1 && !strcmp(positional[0], "@args.rsp"));
+  CHECK(!args_ctx_parse_env(&ctx, "") && !args_ctx_load_file(&ctx, "/etc/hostname"));
+  args_ctx_free(&ctx);
+}
+
+static void test_print(void) {
+  char *argv[] = {"test", "--port=8080", NULL};
+  args_parse(TEST_ARGC(argv), argv);
+  char buf[256];
+  size_t len = args_format(buf, sizeof(buf));
+  test_output_len = 0;
+  args_print();
+  CHECK(len && len < sizeof(buf) && test_output_len == len && !memcmp(test_output, buf, len));
+  args_free();
+}
+
+// Freed blocks are given back from the end, scratch memory doesn't use up the static heap
+static void test_static_heap(void) {
+  static char names[48][8];
+  args_spec_t spec[48];
+  int values[48];
+  for (int i = 0; i < 48; ++i) {
+    memcpy(names[i], "--o", 3);
+    names[i][3] = (char)('0' + i / 10);
+    names[i][4] = (char)('0' + i % 10);
+    names[i][5] = '\0';
+    spec[i] = (args_spec_t){names[i], ARGS_INT, i * sizeof(int), "1"};
+  }
+  char *argv[] = {"test", "--o00=5", "--o47", "9", NULL};
+  size_t used = args__static_heap_used;
+  for (int round = 0; round < 1000; ++round) {
+    args_ctx_t ctx;
+    args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+    CHECK(args_ctx_parse_into(&ctx, spec, 48, values) == ARGS_OK && values[0] == 5 && values[47] == 9);
+    args_ctx_free(&ctx);
+  }
+  CHECK(args__static_heap_used == used);
+  // Full heap is reported as out of memory
+  static char list[8192] = "--id=1";
+  for (size_t i = 6; i + 2 < sizeof(list); i += 2) memcpy(list + i, ",1", 2);
+  char *big[] = {"test", list, NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(big), big);
+  size_t n = 0;
+  CHECK(!args_ctx_int_list(&ctx, "--id", &n) && n > 0);
+  CHECK(args_ctx_string_view(&ctx, "--id").len == strlen(list) - 5);
+  args_ctx_free(&ctx);
+  CHECK(args__static_heap_used == used);
+}
+
+int main(void) {
+  test_lookup();
+  test_print();
+  test_static_heap();
+  if (test_failed) test_puts("checks failed\n");
+  else {
+    ssize_t written = write(1, "all tests passed\n", 17);
+    (void)written;
+  }
+  return test_failed != 0;
+}
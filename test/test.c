@@ -0,0 +1,736 @@
+// make test
+// ./test/test && ./test/test-features
+//
+// Behavior tests of args.h, one block per feature. Blocks of `ARGS_STATS`, `ARGS_CACHE_SIZE` and `ARGS_THREADS`
+// run in `./test/test-features`, which is built with them.
+// Prints failed checks and exits with 1 if there are any.
+
+#define ARGS_IMPLEMENTATION
+#include "../args.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef ARGS_THREADS
+#include <pthread.h>
+#endif // ARGS_THREADS
+
+static int test_failed;
+
+#define CHECK(cond)                                                                                                    \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);                                                     \
+      test_failed++;                                                                                                   \
+    }                                                                                                                  \
+  } while (0)
+
+#define TEST_ARGC(argv) ((int)(sizeof(argv) / sizeof(*(argv))) - 1)
+
+// Write `text` to a new temporary file, its path is stored in `path` of at least 32 bytes.
+static bool test_write_file(char *path, const char *text) {
+  strcpy(path, "/tmp/args-test-XXXXXX");
+  int fd = mkstemp(path);
+  if (fd < 0) return false;
+  size_t len = strlen(text);
+  bool ok = write(fd, text, len) == (ssize_t)len;
+  close(fd);
+  return ok;
+}
+
+static void test_lookup(void) {
+  char *argv[] = {"test", "-v", "--port", "8080", "--name=\"John Smith\"", "--ratio=0.5", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_bool(&ctx, "-v|--verbose"));
+  CHECK(!args_ctx_bool(&ctx, "-q|--quiet"));
+  CHECK(args_ctx_int(&ctx, "--port") == 8080);
+  CHECK(args_ctx_float(&ctx, "--ratio") == 0.5);
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.len == 10 && !memcmp(name.ptr, "John Smith", 10));
+  args_ctx_free(&ctx);
+}
+
+// Clusters are decoded only from letters of `short_options`
+static void test_short_clusters(void) {
+  char *argv[] = {"test", "-abc", "-p9000", "-ofile.txt", "-vIinclude", "-lm", "-version", "-help", "-ab", "x", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(!args_ctx_bool(&ctx, "-a") && !args_ctx_bool(&ctx, "-p") && args_ctx_bool(&ctx, "-abc"));
+  args_ctx_free(&ctx);
+  args_parse_opts_t opts = {.short_options = "abcvp:o:I:l:"};
+  CHECK(args_ctx_init_opts(&ctx, TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+  CHECK(args_ctx_bool(&ctx, "-a") && args_ctx_bool(&ctx, "-c") && args_ctx_int(&ctx, "-p") == 9000);
+  CHECK(!strcmp(args_ctx_string(&ctx, "-o"), "file.txt") && !strcmp(args_ctx_string(&ctx, "-I"), "include"));
+  CHECK(!strcmp(args_ctx_string(&ctx, "-l"), "m"));
+  // Last flag of a cluster takes the next argument
+  CHECK(!strcmp(args_ctx_string(&ctx, "-b"), "x"));
+  // Single dash long options with unlisted letters stay whole
+  CHECK(args_ctx_bool(&ctx, "-version") && args_ctx_bool(&ctx, "-help") && !args_ctx_bool(&ctx, "-h"));
+  CHECK(args_ctx_bool(&ctx, "-v") && !args_ctx_bool(&ctx, "-e") && !args_ctx_bool(&ctx, "-n"));
+  args_ctx_free(&ctx);
+}
+
+// Empty `--flag=` is not an unterminated quote
+static void test_empty_value(void) {
+  char *argv[] = {"test", "--name=", "--quoted=\"", "--open=\"a b", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.ptr && name.len == 0);
+  CHECK(!strcmp(args_ctx_string(&ctx, "--name"), ""));
+  args_string_view_t quoted = args_ctx_string_view(&ctx, "--quoted");
+  CHECK(quoted.ptr && quoted.len == 0);
+  args_string_view_t open = args_ctx_string_view(&ctx, "--open");
+  CHECK(open.len == 3 && !memcmp(open.ptr, "a b", 3));
+  args_ctx_free(&ctx);
+}
+
+static void test_choice(void) {
+  static const char *const modes[] = {"fast", "balanced", "safe", "FAST"};
+  char *argv[] = {"test", "--mode=Safe", "--other=slow", "--x=maybe", "--y=Off", "--z", "maybe", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_choice(&ctx, "--mode", modes, 4) == 2);
+  CHECK(args_ctx_choice(&ctx, "--missing", modes, 4) == -1);
+  int index = 7;
+  CHECK(args_ctx_choice_ex(&ctx, "--other", modes, 4, &index) == ARGS_ERR_INVALID && index == 7);
+  CHECK(args_ctx_choice_ex(&ctx, "--missing", modes, 4, &index) == ARGS_ERR_MISSING);
+  // Boolean words are one table for access functions and `args_parse_into()`
+  CHECK(!args_ctx_bool(&ctx, "--x") && !args_ctx_bool(&ctx, "--y") && args_ctx_bool(&ctx, "--z"));
+  bool flags[3] = {true, true, false};
+  static const args_spec_t spec[] = {
+      {"--x", ARGS_BOOL, 0, "yes"},
+      {"--y", ARGS_BOOL, 1, "on"},
+      {"--z", ARGS_BOOL, 2, NULL},
+  };
+  CHECK(args_ctx_parse_into(&ctx, spec, 3, flags) == ARGS_ERR_INVALID);
+  CHECK(flags[0] && !flags[1] && flags[2]);
+  static const args_spec_t bad_default[] = {{"--w", ARGS_BOOL, 0, "maybe"}};
+  CHECK(args_ctx_parse_into(&ctx, bad_default, 1, flags) == ARGS_ERR_INVALID);
+  args_ctx_free(&ctx);
+}
+
+static void test_integers(void) {
+  char *argv[] = {"test", "--a=9223372036854775807", "--b=-9223372036854775808", "--c=9223372036854775808",
+                  "--d=0xFFFFFFFFFFFFFFFF", "--e=0x10000000000000000", "--f=-1", "--g=0xff", "--h=-0x10",
+                  "--i=2147483648", "--j=12a", "--k=0x", "--l=", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  int64_t i64 = 7;
+  uint64_t u64 = 7;
+  int i = 7;
+  CHECK(args_ctx_int64(&ctx, "--a") == INT64_MAX && args_ctx_int64(&ctx, "--b") == INT64_MIN);
+  CHECK(args_ctx_int64_ex(&ctx, "--c", &i64) == ARGS_ERR_RANGE && i64 == 7);
+  CHECK(args_ctx_uint64(&ctx, "--c") == 9223372036854775808ull && args_ctx_uint64(&ctx, "--d") == UINT64_MAX);
+  CHECK(args_ctx_uint64_ex(&ctx, "--e", &u64) == ARGS_ERR_RANGE && u64 == 7);
+  CHECK(args_ctx_uint64_ex(&ctx, "--f", &u64) == ARGS_ERR_RANGE && args_ctx_int64(&ctx, "--f") == -1);
+  CHECK(args_ctx_int(&ctx, "--g") == 255 && args_ctx_int(&ctx, "--h") == -16);
+  CHECK(args_ctx_int_ex(&ctx, "--i", &i) == ARGS_ERR_RANGE && i == 7 && args_ctx_int64(&ctx, "--i") == 2147483648);
+  CHECK(args_ctx_int_ex(&ctx, "--j", &i) == ARGS_ERR_INVALID && args_ctx_int_ex(&ctx, "--k", &i) == ARGS_ERR_INVALID);
+  CHECK(args_ctx_int_ex(&ctx, "--l", &i) == ARGS_ERR_INVALID && args_ctx_int_ex(&ctx, "--m", &i) == ARGS_ERR_MISSING);
+  args_ctx_free(&ctx);
+}
+
+// Floats are correctly rounded, so they match glibc's `strtod()` bit for bit
+static void test_float_rounding(void) {
+  static const char *const values[] = {
+      // Halfway cases round to even
+      "9007199254740993", "9007199254740995", "1.00000000000000011102230246251565404236316680908203125",
+      "1.00000000000000011102230246251565404236316680908203126",
+      // Subnormals, the smallest one and the halfway point below it
+      "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "2.2250738585072011e-308",
+      "2.2250738585072012e-308",
+      // Around limits of the fast path: 19 and 20 digits, mantissa of 2^53 and 10^22
+      "1234567890123456789", "12345678901234567890", "0.1234567890123456789e5", "9007199254740992e22",
+      "1.7976931348623157e308", "-0.0", "1e-400"};
+  char arg[128];
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    snprintf(arg, sizeof(arg), "--x=%s", values[i]);
+    char *argv[] = {"test", arg, NULL};
+    args_ctx_t ctx;
+    args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+    double value = 0, expected = strtod(values[i], NULL);
+    CHECK(args_ctx_float_ex(&ctx, "--x", &value) == ARGS_OK && !memcmp(&value, &expected, sizeof(value)));
+    args_ctx_free(&ctx);
+  }
+  // Overflow is an error rather than infinity
+  char *argv[] = {"test", "--a=1e309", "--b=1.7976931348623159e308", "--c=-1e400", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  double value = 1;
+  CHECK(args_ctx_float_ex(&ctx, "--a", &value) == ARGS_ERR_RANGE && value == 1);
+  CHECK(args_ctx_float_ex(&ctx, "--b", &value) == ARGS_ERR_RANGE);
+  CHECK(args_ctx_float_ex(&ctx, "--c", &value) == ARGS_ERR_RANGE);
+  args_ctx_free(&ctx);
+}
+
+static void test_bytes_duration(void) {
+  char *argv[] = {"test", "--a=4K", "--b=2GiB", "--c=1KB", "--d=1.5k", "--e=1E", "--f=1eb", "--g=1eib", "--h=1e",
+                  "--i=16E", "--j=1x", "--t=250ms", "--u=1h30m", "--v=1.5s", "--w=10", "--x=5\xC2\xB5s",
+                  "--y=213504d", "--z=5 s", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_bytes(&ctx, "--a") == 4096 && args_ctx_bytes(&ctx, "--b") == 2ull << 30);
+  CHECK(args_ctx_bytes(&ctx, "--c") == 1000 && args_ctx_bytes(&ctx, "--d") == 1536);
+  CHECK(args_ctx_bytes(&ctx, "--e") == 1ull << 60 && args_ctx_bytes(&ctx, "--f") == 1000000000000000000ull);
+  CHECK(args_ctx_bytes(&ctx, "--g") == 1ull << 60);
+  uint64_t out = 7;
+  CHECK(args_ctx_bytes_ex(&ctx, "--h", &out) == ARGS_ERR_INVALID && out == 7);
+  CHECK(args_ctx_bytes_ex(&ctx, "--i", &out) == ARGS_ERR_RANGE);
+  CHECK(args_ctx_bytes_ex(&ctx, "--j", &out) == ARGS_ERR_INVALID && !args_ctx_bytes(&ctx, "--j"));
+  CHECK(args_ctx_bytes_ex(&ctx, "--missing", &out) == ARGS_ERR_MISSING && out == 7);
+  CHECK(args_ctx_duration_ns(&ctx, "--t") == 250000000ull && args_ctx_duration_ns(&ctx, "--u") == 5400000000000ull);
+  CHECK(args_ctx_duration_ns(&ctx, "--v") == 1500000000ull && args_ctx_duration_ns(&ctx, "--w") == 10000000000ull);
+  CHECK(args_ctx_duration_ns(&ctx, "--x") == 5000);
+  CHECK(args_ctx_duration_ns_ex(&ctx, "--y", &out) == ARGS_ERR_RANGE);
+  CHECK(args_ctx_duration_ns_ex(&ctx, "--z", &out) == ARGS_ERR_INVALID);
+  args_ctx_free(&ctx);
+}
+
+static void test_lists(void) {
+  char *argv[] = {"test", "--id", "1", "--id=2,3", "--x=1.5,2.5", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  size_t count = 0;
+  const int64_t *ids = args_ctx_int_list(&ctx, "--id", &count);
+  CHECK(ids && count == 3 && ids[0] == 1 && ids[1] == 2 && ids[2] == 3);
+  const double *xs = args_ctx_float_list(&ctx, "--x", &count);
+  CHECK(xs && count == 2 && xs[0] == 1.5 && xs[1] == 2.5);
+  args_ctx_free(&ctx);
+}
+
+static void test_response_file(void) {
+  char path[32], arg[40];
+  if (!test_write_file(path, "--port 8080\n--name \"John Smith\" --city=\"New York\"\n")) {
+    CHECK(!"can't write response file");
+    return;
+  }
+  snprintf(arg, sizeof(arg), "@%s", path);
+  char *argv[] = {"test", arg, "-v", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_int(&ctx, "--port") == 8080);
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.len == 10 && !memcmp(name.ptr, "John Smith", 10));
+  args_string_view_t city = args_ctx_string_view(&ctx, "--city");
+  CHECK(city.len == 8 && !memcmp(city.ptr, "New York", 8));
+  CHECK(args_ctx_bool(&ctx, "-v"));
+  args_ctx_free(&ctx);
+  unlink(path);
+}
+
+// Quoted clusters are decoded the same way when counting and when collecting tokens
+static void test_response_file_clusters(void) {
+  char path[32], arg[40];
+  if (!test_write_file(path, "\"-abc\" \"-xyz\" --name \"John Smith\"\n-def\n")) {
+    CHECK(!"can't write response file");
+    return;
+  }
+  snprintf(arg, sizeof(arg), "@%s", path);
+  char *argv[] = {"test", arg, "-q", NULL};
+  args_ctx_t ctx;
+  args_parse_opts_t opts = {.short_options = "abcdefxyz"};
+  CHECK(args_ctx_init_opts(&ctx, TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+  CHECK(args_ctx_bool(&ctx, "-a") && args_ctx_bool(&ctx, "-c") && args_ctx_bool(&ctx, "-z"));
+  CHECK(args_ctx_bool(&ctx, "-d") && args_ctx_bool(&ctx, "-f") && args_ctx_bool(&ctx, "-q"));
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.len == 10 && !memcmp(name.ptr, "John Smith", 10));
+  args_ctx_free(&ctx);
+  unlink(path);
+}
+
+static void test_config_file(void) {
+  char path[32];
+  const char *text = "# comment\nport = \"8080\"\nname = \"John Smith\"\nids=\"1,2\"\nratio = 0.5\nverbose\n";
+  if (!test_write_file(path, text)) {
+    CHECK(!"can't write config file");
+    return;
+  }
+  char *argv[] = {"test", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_load_file(&ctx, path));
+  int64_t port = 0;
+  CHECK(args_ctx_int64_ex(&ctx, "--port", &port) == ARGS_OK && port == 8080);
+  CHECK(args_ctx_float(&ctx, "--ratio") == 0.5 && args_ctx_bool(&ctx, "--verbose"));
+  CHECK(!strcmp(args_ctx_string(&ctx, "--name"), "John Smith"));
+  size_t count = 0;
+  const int64_t *ids = args_ctx_int_list(&ctx, "--ids", &count);
+  CHECK(ids && count == 2 && ids[0] == 1 && ids[1] == 2);
+  args_ctx_free(&ctx);
+  unlink(path);
+}
+
+static void test_env(void) {
+  setenv("ARGS_TEST_PORT", "9000", 1);
+  setenv("ARGS_TEST_MAX_SIZE", "64", 1);
+  setenv("ARGS_TEST_NAME", "John Smith", 1);
+  char *argv[] = {"test", "--port=8080", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_parse_env(&ctx, "ARGS_TEST_"));
+  // Variables are snapshotted, command line wins over them
+  setenv("ARGS_TEST_NAME", "changed", 1);
+  CHECK(args_ctx_int(&ctx, "-p|--port") == 8080 && args_ctx_int(&ctx, "--max-size") == 64);
+  CHECK(!strcmp(args_ctx_string(&ctx, "--name"), "John Smith"));
+  args_ctx_free(&ctx);
+  // Out of memory adds no layer and leaves the context as it was
+  static unsigned char buf[4096];
+  size_t need = args_ctx_init_arena(&ctx, TEST_ARGC(argv), argv, NULL, 0);
+  args_ctx_free(&ctx);
+  CHECK(args_ctx_init_arena(&ctx, TEST_ARGC(argv), argv, buf, need) == need);
+  size_t used = ctx.arena_used;
+  CHECK(!args_ctx_parse_env(&ctx, "ARGS_TEST_"));
+  CHECK(!ctx.layers && ctx.arena_used == used);
+  CHECK(args_ctx_int(&ctx, "--port") == 8080 && !args_ctx_int(&ctx, "--max-size"));
+  args_ctx_free(&ctx);
+  unsetenv("ARGS_TEST_PORT");
+  unsetenv("ARGS_TEST_MAX_SIZE");
+  unsetenv("ARGS_TEST_NAME");
+}
+
+static void test_serialize(void) {
+  static unsigned char blob[8192] __attribute__((aligned(16))), copy[8192] __attribute__((aligned(16)));
+  char *argv[] = {"test", "--port=8080", "--ratio", "0.5", "--big=99999999999999999999", "-v", NULL};
+  args_ctx_t ctx, attached;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  setenv("ARGS_TEST_NAME", "John", 1);
+  CHECK(args_ctx_parse_env(&ctx, "ARGS_TEST_"));
+  unsetenv("ARGS_TEST_NAME");
+  size_t size = args_ctx_serialize(&ctx, NULL, 0);
+  CHECK(size && size <= sizeof(blob) && args_ctx_serialize(&ctx, blob, sizeof(blob)) == size);
+  args_ctx_free(&ctx);
+  CHECK(args_ctx_attach(&attached, blob, size));
+  int64_t big = 0;
+  CHECK(args_ctx_int(&attached, "--port") == 8080 && args_ctx_float(&attached, "--ratio") == 0.5);
+  CHECK(args_ctx_int64_ex(&attached, "--big", &big) == ARGS_ERR_RANGE && args_ctx_bool(&attached, "-v"));
+  CHECK(!strcmp(args_ctx_string(&attached, "--name"), "John"));
+  args_ctx_free(&attached);
+  // Truncated, misaligned and foreign blobs are rejected
+  CHECK(!args_ctx_attach(&attached, blob, size - 1) && !attached.ntokens);
+  memcpy(copy + 1, blob, size);
+  CHECK(!args_ctx_attach(&attached, copy + 1, size));
+  memcpy(copy, blob, size);
+  copy[0] ^= 1;
+  CHECK(!args_ctx_attach(&attached, copy, size));
+  // Error of a converted value must be an `args_err_t`
+  memcpy(copy, blob, size);
+  const args__blob_index_t *index = (const args__blob_index_t *)(copy + args__align(sizeof(args__blob_t)));
+  ((args__value_t *)(copy + index->values))[0].i64_err = ARGS_ERR_NOMEM + 1;
+  CHECK(!args_ctx_attach(&attached, copy, size));
+  args_ctx_free(&attached);
+}
+
+static void test_registry(void) {
+  char *argv[] = {"test", "--port=8080", "-v", "--bogus", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_register(&ctx, "-p|--port") == 0 && args_ctx_register(&ctx, "-v|--verbose") == 1);
+  // Enough flags for buckets with several keys
+  static char names[200][24];
+  for (int i = 0; i < 200; ++i) {
+    snprintf(names[i], sizeof(names[i]), "--flag-%d|-F%d", i, i);
+    CHECK(args_ctx_register(&ctx, names[i]) == i + 2);
+  }
+  // Classification is unavailable until freezing
+  CHECK(args_ctx_classify(&ctx, "--port") == -1);
+  CHECK(args_ctx_freeze(&ctx));
+  CHECK(args_ctx_register(&ctx, "--late") == -1);
+  CHECK(args_ctx_classify(&ctx, "--port") == 0 && args_ctx_classify(&ctx, "-p=1") == 0);
+  CHECK(args_ctx_classify(&ctx, "--verbose") == 1 && args_ctx_classify(&ctx, "--bogus") == -1);
+  CHECK(args_ctx_classify(&ctx, "--por") == -1 && args_ctx_classify(&ctx, "") == -1);
+  char variant[16];
+  for (int i = 0; i < 200; ++i) {
+    snprintf(variant, sizeof(variant), "-F%d", i);
+    CHECK(args_ctx_classify(&ctx, variant) == i + 2);
+  }
+  // Arguments are still read as usual
+  CHECK(args_ctx_int(&ctx, "-p|--port") == 8080 && args_ctx_bool(&ctx, "-v|--verbose"));
+  args_ctx_free(&ctx);
+}
+
+static void test_abbreviations(void) {
+  char *argv[] = {"test", "--verb", "--col=red", "--out", "x.txt", "--ver", "--colr", "--", "--verb", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  static const char verbose[] = "-v|--verbose", color[] = "--color|--colour";
+  CHECK(args_ctx_register(&ctx, verbose) == 0 && args_ctx_register(&ctx, "--version") == 1);
+  CHECK(args_ctx_register(&ctx, color) == 2 && args_ctx_register(&ctx, "-o|--output") == 3);
+  CHECK(args_ctx_freeze(&ctx));
+  // Unambiguous prefixes only, variants of one flag count once
+  CHECK(args_ctx_resolve(&ctx, "--verb") == 0 && args_ctx_resolve(&ctx, "--ver") == -1);
+  CHECK(args_ctx_resolve(&ctx, "--col=red") == 2 && args_ctx_resolve(&ctx, "--version") == 1);
+  CHECK(args_ctx_resolve(&ctx, "-") == -1 && args_ctx_resolve(&ctx, "--") == -1);
+  CHECK(args_ctx_resolve(&ctx, "-ver") == -1);
+  // Arguments after a bare `--` are not abbreviated
+  CHECK(args_ctx_abbreviate(&ctx) == 3);
+  CHECK(args_ctx_bool(&ctx, verbose) && !strcmp(args_ctx_string(&ctx, color), "red"));
+  CHECK(!strcmp(args_ctx_string(&ctx, "-o|--output"), "x.txt"));
+  args_string_view_t suggestion = args_ctx_suggest(&ctx, "--colr");
+  CHECK(suggestion.len == 7 && !memcmp(suggestion.ptr, "--color", 7));
+  suggestion = args_ctx_suggest(&ctx, "--outptu");
+  CHECK(suggestion.len == 8 && !memcmp(suggestion.ptr, "--output", 8));
+  // Ambiguous prefix of 5 bytes is more than one edit away from both flags
+  CHECK(!args_ctx_suggest(&ctx, "--ver").ptr);
+  CHECK(!args_ctx_suggest(&ctx, "--nothing-close").ptr && !args_ctx_suggest(&ctx, "-x").ptr);
+  args_ctx_free(&ctx);
+}
+
+static void test_complete(void) {
+  char *argv[] = {"test", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  args_ctx_register(&ctx, "-v|--verbose");
+  args_ctx_register(&ctx, "-o|--output");
+  args_ctx_register(&ctx, "--color|--colour");
+  args_ctx_register(&ctx, "--version|-v");
+  char buf[128];
+  CHECK(args_ctx_complete_format(&ctx, "tool --ver", 10, buf, sizeof(buf)) == 20);
+  CHECK(!strcmp(buf, "--verbose\n--version\n"));
+  // Word before the cursor is completed, point is clamped to the line
+  CHECK(args_ctx_complete_format(&ctx, "tool --col --x", 10, buf, sizeof(buf)) == 17);
+  CHECK(!strcmp(buf, "--color\n--colour\n"));
+  CHECK(args_ctx_complete_format(&ctx, "tool -", 100, buf, sizeof(buf)) == 52);
+  CHECK(!strncmp(buf, "--color\n--colour\n--output\n--verbose\n--version\n-o\n-v\n", sizeof(buf)));
+  // File names and values are left to the shell
+  CHECK(!args_ctx_complete_format(&ctx, "tool fi", 7, buf, sizeof(buf)) && !buf[0]);
+  CHECK(!args_ctx_complete_format(&ctx, "tool --color=", 13, buf, sizeof(buf)) && !buf[0]);
+  CHECK(!args_ctx_complete_format(&ctx, "tool --x ", 9, buf, sizeof(buf)));
+  // Answer is truncated like `snprintf()`
+  CHECK(args_ctx_complete_format(&ctx, "tool --ver", 10, buf, 5) == 20 && !strcmp(buf, "--ve"));
+  args_ctx_free(&ctx);
+}
+
+#ifdef ARGS_STATS
+static void test_stats(void) {
+  char *argv[] = {"test", "--port=8080", "--id=1,2", NULL};
+  static const char port[] = "--port";
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  args_stats_reset();
+  for (int i = 0; i < 3; ++i) CHECK(args_ctx_int(&ctx, port) == 8080);
+  CHECK(!args_ctx_int(&ctx, "--missing"));
+  args_stats_t stats = args_stats();
+  CHECK(stats.lookups == 4 && stats.misses == 1 && stats.compares >= 1);
+  // Keys are counted by pointer, the most frequent first
+  CHECK(stats.nkeys == 2 && stats.keys[0].arg == port && stats.keys[0].lookups == 3 && stats.keys[1].lookups == 1);
+  args_stats_reset();
+  stats = args_stats();
+  CHECK(!stats.lookups && !stats.misses && !stats.nkeys);
+  args_ctx_free(&ctx);
+}
+#endif // ARGS_STATS
+
+#ifdef ARGS_CACHE_SIZE
+static void test_cache(void) {
+  char *argv[] = {"test", "--port=8080", "--big=99999999999", "--ratio=0.5", NULL};
+  static const char port[] = "--port", big[] = "--big", level[] = "--level";
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  for (int i = 0; i < 3; ++i) {
+    int value = 7;
+    CHECK(args_ctx_int(&ctx, port) == 8080 && !strcmp(args_ctx_string(&ctx, port), "8080"));
+    CHECK(args_ctx_float(&ctx, port) == 8080.0);
+    // Errors are cached as well, `*out` stays untouched
+    CHECK(args_ctx_int_ex(&ctx, big, &value) == ARGS_ERR_RANGE && value == 7);
+    CHECK(args_ctx_int64(&ctx, big) == 99999999999);
+  }
+#ifdef ARGS_STATS
+  CHECK(args_stats().cache_hits > 0);
+#endif // ARGS_STATS
+  // More keys than entries evict each other without mixing up results
+  static char names[4 * ARGS_CACHE_SIZE][16];
+  for (int round = 0; round < 2; ++round)
+    for (int i = 0; i < 4 * ARGS_CACHE_SIZE; ++i) {
+      snprintf(names[i], sizeof(names[i]), "--k%d", i);
+      CHECK(!args_ctx_int(&ctx, names[i]) && args_ctx_int(&ctx, port) == 8080);
+    }
+  // Adding a layer drops cached misses
+  CHECK(!args_ctx_int(&ctx, level));
+  setenv("ARGS_TEST_LEVEL", "3", 1);
+  CHECK(args_ctx_parse_env(&ctx, "ARGS_TEST_"));
+  unsetenv("ARGS_TEST_LEVEL");
+  CHECK(args_ctx_int(&ctx, level) == 3);
+  args_ctx_free(&ctx);
+}
+#endif // ARGS_CACHE_SIZE
+
+typedef struct {
+  int port;
+  bool verbose;
+  const char *name;
+} test_config_t;
+
+static const args_spec_t test_spec[] = {
+    {"-p|--port", ARGS_INT, offsetof(test_config_t, port), "1"},
+    {"-v|--verbose", ARGS_BOOL, offsetof(test_config_t, verbose), NULL},
+    {"--name", ARGS_STRING, offsetof(test_config_t, name), "none"},
+};
+
+static void test_parse_into(void) {
+  char *argv[] = {"test", "--port", "8080", "-v", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  test_config_t config;
+  CHECK(args_ctx_parse_into(&ctx, test_spec, 3, &config) == ARGS_OK);
+  CHECK(config.port == 8080 && config.verbose && !strcmp(config.name, "none"));
+  args_ctx_free(&ctx);
+  // Tables too large for the stack use scratch memory, an exactly sized arena doesn't run out on repeated calls
+  static char names[48][8];
+  args_spec_t spec[48];
+  int values[48];
+  for (int i = 0; i < 48; ++i) {
+    snprintf(names[i], sizeof(names[i]), "--o%d", i);
+    spec[i] = (args_spec_t){names[i], ARGS_INT, i * sizeof(int), "1"};
+  }
+  char *many[] = {"test", "--o0=5", "--o47", "9", NULL};
+  static unsigned char buf[4096];
+  size_t need = args_ctx_init_arena(&ctx, TEST_ARGC(many), many, NULL, 0);
+  args_ctx_free(&ctx);
+  CHECK(args_ctx_init_arena(&ctx, TEST_ARGC(many), many, buf, need) == need);
+  for (int round = 0; round < 100; ++round) {
+    CHECK(args_ctx_parse_into(&ctx, spec, 48, values) == ARGS_OK);
+    CHECK(values[0] == 5 && values[1] == 1 && values[47] == 9);
+  }
+  args_ctx_free(&ctx);
+}
+
+static void test_leftover(void) {
+  char *argv[] = {"test", "--port", "8080", "--bogus", "input.txt", "--", "-v", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_int(&ctx, "--port") == 8080);
+  size_t n = 0;
+  const char *const *unknown = args_ctx_unknown(&ctx, &n);
+  CHECK(unknown && n == 1 && !strcmp(unknown[0], "--bogus"));
+  const char *const *positional = args_ctx_positional(&ctx, &n);
+  CHECK(positional && n == 2 && !strcmp(positional[0], "input.txt") && !strcmp(positional[1], "-v"));
+  args_ctx_free(&ctx);
+}
+
+// Occurrences of a key are consumed once per use, a later value lookup still consumes the values
+static void test_leftover_repeated(void) {
+  char *argv[] = {"test", "--name", "a", "-v", "--name", "b", "-v", "input.txt", NULL};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  CHECK(args_ctx_bool(&ctx, "--name") && args_ctx_bool(&ctx, "--name"));
+  size_t n = 0;
+  args_ctx_positional(&ctx, &n);
+  CHECK(n == 3);
+  args_string_view_t name = args_ctx_string_view(&ctx, "--name");
+  CHECK(name.len == 1 && name.ptr[0] == 'b');
+  CHECK(args_ctx_bool(&ctx, "-v"));
+  const char *const *positional = args_ctx_positional(&ctx, &n);
+  CHECK(positional && n == 1 && !strcmp(positional[0], "input.txt"));
+  args_ctx_unknown(&ctx, &n);
+  CHECK(n == 0);
+  args_ctx_free(&ctx);
+}
+
+static void test_default_ctx(void) {
+  char *argv[] = {"test", "--port", "8080", NULL};
+  args_parse(TEST_ARGC(argv), argv);
+  CHECK(args_int("--port") == 8080);
+  unsigned reader;
+  const args_ctx_t *ctx = args_read_begin(&reader);
+  CHECK(args_ctx_int(ctx, "--port") == 8080);
+  args_read_end(reader);
+  args_free();
+}
+
+// Reloads keep the options of `args_parse_opts()` and can stay in arenas
+static void test_reload(void) {
+  char *argv[] = {"test", "--port", "8080", NULL};
+  char *next[] = {"test", "--port", "9090", "--a", "--b", "--c", NULL};
+  args_parse_opts_t opts = {.max_tokens = 4, .seed = 12345};
+  CHECK(args_parse_opts(TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+  CHECK(!args_reload(TEST_ARGC(next), next, NULL, NULL));
+  CHECK(args_int("--port") == 8080);
+  CHECK(args_reload(4, next, NULL, NULL));
+  CHECK(args_int("--port") == 9090 && args_bool("--a"));
+  CHECK(args_default_ctx()->seed == 12345);
+  static unsigned char arenas[2][4096];
+  args_ctx_t ctx;
+  size_t need = args_ctx_init_arena(&ctx, 4, next, NULL, 0) + sizeof(args_ctx_t) + 64;
+  args_ctx_free(&ctx);
+  CHECK(!args_reload_arena(4, next, arenas[0], 64, NULL, NULL));
+  CHECK(args_reload_arena(4, next, arenas[0], need, NULL, NULL));
+  CHECK(args_reload_arena(TEST_ARGC(argv), argv, arenas[1], sizeof(arenas[1]), NULL, NULL));
+  CHECK(args_int("--port") == 8080 && !args_bool("--a"));
+  CHECK(args_reload_arena(4, next, arenas[0], sizeof(arenas[0]), NULL, NULL));
+  CHECK(args_int("--port") == 9090);
+  args_free();
+}
+
+#ifdef ARGS_THREADS
+// List of `n` items `i * scale + offset`, as `prefix<item>,<item>...`
+static char *test_list(const char *prefix, size_t n, const char *format, size_t scale) {
+  char *list = (char *)malloc(strlen(prefix) + n * 24 + 1);
+  size_t len = (size_t)sprintf(list, "%s", prefix);
+  for (size_t i = 0; i < n; ++i) len += (size_t)sprintf(list + len, format, i ? "," : "", i * scale);
+  return list;
+}
+
+static void test_threads_lists(void) {
+  const size_t n = 100003;
+  char *ids = test_list("--ids=", n, "%s%zu", 3), *ratios = test_list("--f=", n, "%s%zu.5", 1);
+  char *argv[] = {"test", "--ids=7", ids, "--ids", "1,2", ratios, NULL};
+  // Chunks are split for any number of threads, more threads than items included
+  for (size_t threads = 1; threads <= 81; threads *= 3) {
+    args_parse_opts_t opts = {.threads = threads};
+    args_ctx_t ctx;
+    CHECK(args_ctx_init_opts(&ctx, TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+    size_t count = 0, wrong = 0;
+    const int64_t *values = args_ctx_int_list(&ctx, "--ids", &count);
+    CHECK(values && count == n + 3 && values[0] == 7 && values[n + 1] == 1 && values[n + 2] == 2);
+    for (size_t i = 0; values && i < n; ++i) wrong += values[i + 1] != (int64_t)(i * 3);
+    const double *floats = args_ctx_float_list(&ctx, "--f", &count);
+    CHECK(floats && count == n);
+    for (size_t i = 0; floats && i < n; ++i) wrong += floats[i] != (double)i + 0.5;
+    CHECK(!wrong);
+    args_ctx_free(&ctx);
+  }
+  // Malformed item in the last chunk fails the whole list
+  ids[strlen(ids) - 1] = 'x';
+  args_parse_opts_t opts = {.threads = 4};
+  args_ctx_t ctx;
+  CHECK(args_ctx_init_opts(&ctx, TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+  size_t count = 1;
+  CHECK(!args_ctx_int_list(&ctx, "--ids", &count) && !count);
+  args_ctx_free(&ctx);
+  free(ids);
+  free(ratios);
+}
+
+static int test_reader_stop;
+
+static void *test_reader(void *arg) {
+  size_t *bad = (size_t *)arg;
+  while (!__atomic_load_n(&test_reader_stop, __ATOMIC_ACQUIRE)) {
+    int port = args_int("--port");
+    if (port != 8080 && port != 9090) (*bad)++;
+    // Values of one context are consistent and stay valid while it is read or held
+    unsigned reader;
+    const args_ctx_t *ctx = args_read_begin(&reader);
+    size_t count = 0;
+    const int64_t *ids = args_ctx_int_list(ctx, "--ids", &count);
+    if (!ids || count != 3 || ids[2] != args_ctx_int(ctx, "--port")) (*bad)++;
+    args_read_end(reader);
+    ctx = args_acquire();
+    ids = args_ctx_int_list(ctx, "--ids", &count);
+    if (!ids || count != 3 || ids[2] != args_ctx_int(ctx, "--port")) (*bad)++;
+    args_release(ctx);
+  }
+  return NULL;
+}
+
+// Readers see either the old or the new context, reloads keep the options of `args_parse_opts()`
+static void test_threads_reload(void) {
+  char *argv[] = {"test", "--port=8080", "--ids=1,2,8080", NULL};
+  char *next[] = {"test", "--port=9090", "--ids=1,2,9090", NULL};
+  args_parse_opts_t opts = {.seed = 777, .threads = 2};
+  CHECK(args_parse_opts(TEST_ARGC(argv), argv, &opts) == ARGS_OK);
+  pthread_t readers[4];
+  size_t bad[4] = {0};
+  test_reader_stop = 0;
+  for (int i = 0; i < 4; ++i) pthread_create(&readers[i], NULL, test_reader, &bad[i]);
+  for (int i = 0; i < 200; ++i) CHECK(args_reload(TEST_ARGC(argv), i % 2 ? argv : next, NULL, NULL));
+  __atomic_store_n(&test_reader_stop, 1, __ATOMIC_RELEASE);
+  for (int i = 0; i < 4; ++i) {
+    pthread_join(readers[i], NULL);
+    CHECK(!bad[i]);
+  }
+  CHECK(args_default_ctx()->seed == 777 && args_default_ctx()->threads == 2);
+  CHECK(args_int("--port") == 8080);
+  args_free();
+}
+#endif // ARGS_THREADS
+
+static void test_subcommand(void) {
+  static const char *const commands[] = {"build", "rm|remove", "gc"};
+  char *argv[] = {"test", "remove", "-f", "x", NULL};
+  args_ctx_t ctx;
+  CHECK(args_ctx_subcommand(&ctx, TEST_ARGC(argv), argv, commands, 3) == 1);
+  CHECK(args_ctx_bool(&ctx, "-f") && !strcmp(ctx.argv[0], "remove"));
+  args_ctx_free(&ctx);
+  char *other[] = {"test", "rmx", "-f", NULL};
+  CHECK(args_ctx_subcommand(&ctx, TEST_ARGC(other), other, commands, 3) == -1);
+  CHECK(args_ctx_bool(&ctx, "-f"));
+  args_ctx_free(&ctx);
+}
+
+static void test_arena(void) {
+  char *argv[] = {"test", "--port", "8080", "-v", NULL};
+  static unsigned char buf[4096];
+  args_ctx_t ctx;
+  CHECK(args_ctx_init_arena(&ctx, TEST_ARGC(argv), argv, buf, sizeof(buf)) <= sizeof(buf));
+  CHECK(args_ctx_int(&ctx, "--port") == 8080 && args_ctx_bool(&ctx, "-v"));
+  args_ctx_free(&ctx);
+  // Reported size is enough for parse_into and leftover arguments
+  char *more[] = {"test", "--port", "8080", "-v", "--bogus", "input.txt", "--id=1,2,3", NULL};
+  size_t need = args_ctx_init_arena(&ctx, TEST_ARGC(more), more, NULL, 0);
+  args_ctx_free(&ctx);
+  CHECK(need <= sizeof(buf));
+  CHECK(args_ctx_init_arena(&ctx, TEST_ARGC(more), more, buf, need) == need);
+  test_config_t config;
+  CHECK(args_ctx_parse_into(&ctx, test_spec, 3, &config) == ARGS_OK);
+  CHECK(config.port == 8080 && config.verbose);
+  size_t n = 0;
+  const char *const *unknown = args_ctx_unknown(&ctx, &n);
+  CHECK(unknown && n == 2 && !strcmp(unknown[0], "--bogus") && !strcmp(unknown[1], "--id=1,2,3"));
+  const char *const *positional = args_ctx_positional(&ctx, &n);
+  CHECK(positional && n == 1 && !strcmp(positional[0], "input.txt"));
+  // Full arena is reported, not mistaken for a missing argument
+  const int64_t *ids = args_ctx_int_list(&ctx, "--id", &n);
+  CHECK(!ids && n == 3);
+  unknown = args_ctx_unknown(&ctx, &n);
+  CHECK(!unknown && n == 1);
+  args_ctx_free(&ctx);
+  // Too small arena leaves the context empty
+  CHECK(args_ctx_init_arena(&ctx, TEST_ARGC(argv), argv, buf, 16) > 16);
+  CHECK(!args_ctx_int(&ctx, "--port"));
+  args_ctx_free(&ctx);
+}
+
+int main(void) {
+  test_lookup();
+  test_empty_value();
+  test_short_clusters();
+  test_choice();
+  test_integers();
+  test_float_rounding();
+  test_bytes_duration();
+  test_lists();
+  test_response_file();
+  test_response_file_clusters();
+  test_config_file();
+  test_env();
+  test_serialize();
+  test_registry();
+  test_abbreviations();
+  test_complete();
+#ifdef ARGS_STATS
+  test_stats();
+#endif // ARGS_STATS
+#ifdef ARGS_CACHE_SIZE
+  test_cache();
+#endif // ARGS_CACHE_SIZE
+  test_parse_into();
+  test_leftover();
+  test_leftover_repeated();
+  test_subcommand();
+  test_arena();
+  test_default_ctx();
+  test_reload();
+#ifdef ARGS_THREADS
+  test_threads_lists();
+  test_threads_reload();
+#endif // ARGS_THREADS
+  if (test_failed) fprintf(stderr, "%d checks failed\n", test_failed);
+  else printf("all tests passed\n");
+  return test_failed != 0;
+}
@@ -0,0 +1,77 @@
+// make test
+// ./test/test-cpp
+//
+// Behavior tests of args.hpp: compile-time keys, `args::find()` and `args::get()` for every supported type.
+// Prints failed checks and exits with 1 if there are any.
+
+#define ARGS_IMPLEMENTATION
+#include "../args.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+static int test_failed;
+
+#define CHECK(cond)                                                                                                    \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);                                                \
+      test_failed++;                                                                                                   \
+    }                                                                                                                  \
+  } while (0)
+
+#define TEST_ARGC(argv) ((int)(sizeof(argv) / sizeof(*(argv))) - 1)
+
+// Keys are split and hashed at compile time, empty variants are skipped
+static constexpr auto test_port = ARGS_KEY("-p||--port|");
+static_assert(test_port.count == 2 && test_port.keys[1].len == 6);
+static_assert(args::hash("", 0) == 2166136261u);
+
+static void test_keys() {
+  CHECK(test_port.keys[0].hash == args_hash("-p", 2) && test_port.keys[1].hash == args_hash("--port", 6));
+  CHECK(!std::memcmp(test_port.keys[1].name, "--port", 6));
+}
+
+static void test_find() {
+  char arg0[] = "test", port[] = "--port", zero[] = "0", verbose[] = "-v", no[] = "no", name[] = "--name=\"Bob X\"",
+       empty[] = "--empty=", ratio[] = "--ratio=0.25", neg[] = "--neg=-5", big[] = "--big=70000", flag[] = "--flag";
+  char *argv[] = {arg0, port, zero, verbose, no, name, empty, ratio, neg, big, flag, nullptr};
+  args_ctx_t ctx;
+  args_ctx_init(&ctx, TEST_ARGC(argv), argv);
+  // Zero and false are told apart from missing arguments
+  std::optional<int> p = args::find<int>(test_port, &ctx);
+  CHECK(p && *p == 0 && !args::find<int>(ARGS_KEY("--missing"), &ctx));
+  std::optional<bool> v = args::find<bool>(ARGS_KEY("-v|--verbose"), &ctx);
+  CHECK(v && !*v && !args::find<bool>(ARGS_KEY("-q"), &ctx));
+  std::optional<std::string_view> n = args::find<std::string_view>(ARGS_KEY("--name"), &ctx);
+  CHECK(n && *n == "Bob X");
+  std::optional<std::string_view> e = args::find<std::string_view>(ARGS_KEY("--empty"), &ctx);
+  CHECK(e && e->empty() && !args::find<std::string_view>(ARGS_KEY("--flag"), &ctx));
+  std::optional<args_string_view_t> view = args::find<args_string_view_t>(ARGS_KEY("--name"), &ctx);
+  CHECK(view && view->len == 5);
+  CHECK(args::find<double>(ARGS_KEY("--ratio"), &ctx) == 0.25 && args::find<float>(ARGS_KEY("--ratio"), &ctx) == 0.25f);
+  // Values out of range of the type are missing
+  CHECK(args::find<short>(ARGS_KEY("--neg"), &ctx) == -5 && !args::find<unsigned>(ARGS_KEY("--neg"), &ctx));
+  CHECK(!args::find<int16_t>(ARGS_KEY("--big"), &ctx) && args::find<uint32_t>(ARGS_KEY("--big"), &ctx) == 70000u);
+  CHECK(args::get<int>(ARGS_KEY("--missing"), &ctx) == 0 && args::get<std::string_view>(ARGS_KEY("--x"), &ctx).empty());
+  args_ctx_free(&ctx);
+}
+
+static void test_default_ctx() {
+  char arg0[] = "test", port[] = "--port=8080", name[] = "--name=Bob";
+  char *argv[] = {arg0, port, name, nullptr};
+  args_parse(TEST_ARGC(argv), argv);
+  static_assert(noexcept(args::find<int>(test_port)) && noexcept(args::get<int>(test_port)));
+  CHECK(args::find<int>(test_port) == 8080 && args::get<long long>(test_port) == 8080);
+  CHECK(args::get<std::string_view>(ARGS_KEY("--name")) == "Bob" && !args::find<bool>(ARGS_KEY("--verbose")));
+  args_free();
+}
+
+int main() {
+  test_keys();
+  test_find();
+  test_default_ctx();
+  if (test_failed) std::fprintf(stderr, "%d checks failed\n", test_failed);
+  else std::printf("all tests passed\n");
+  return test_failed != 0;
+}